@@ -0,0 +1,1260 @@
+#include "animation-trace-sink.h"
+#include "cached-channel-model.h"
+#include "distributed-run.h"
+#include "incremental-beamforming.h"
+#include "kpi-sampler.h"
+#include "latency-stats.h"
+#include "link-quality-probe.h"
+#include "mac-slot-stats.h"
+#include "memory-accounting.h"
+#include "multiplexed-udp-client.h"
+#include "profiling-simulator-impl.h"
+#include "replication-report.h"
+#include "results-writer.h"
+#include "rlc-queue-manager.h"
+#include "run-length-controller.h"
+#include "run-profile.h"
+#include "scenario-parameters.h"
+#include "scheduler-benchmark.h"
+#include "sweep-runner.h"
+#include "topology-layout.h"
+#include "trace-replay.h"
+#include "traffic-source-benchmark.h"
+#include "urllc-traffic.h"
+#include "voip-source.h"
+
+#include "ns3/antenna-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/buildings-module.h"
+#include "ns3/config-store-module.h"
+#include "ns3/core-module.h"
+#include "ns3/flow-monitor-module.h"
+#include "ns3/internet-apps-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/nr-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/spectrum-module.h"
+#include "ns3/netanim-module.h"
+
+#include <cctype>
+
+using namespace ns3;
+
+// Define a log component for the simulation
+NS_LOG_COMPONENT_DEFINE("CttcNrDemo");
+
+int main(int argc, char* argv[])
+{
+    // Load the traffic model preset first so that explicit options override it
+    ScenarioParameters params;
+    params.ApplyTrafficPreset(ScenarioParameters::FindArgument(argc, argv, "traffic", params.traffic));
+
+    // Sweep grid and number of parallel processes
+    std::string sweep;
+    uint32_t jobs = 0;
+    // Binary animation trace to convert to CSV instead of running the scenario
+    std::string decodeAnimation;
+    // KPI time series to convert to CSV instead of running the scenario
+    std::string exportKpiCsv;
+    // UE counts of the scaling benchmark
+    std::string scaling;
+    // Number of independent replications and the configurations they compare
+    uint32_t replications = 0;
+    std::string compare;
+    // Schedulers, UE counts and RBG counts of the scheduler microbenchmark
+    std::string schedulerBenchmark;
+    std::string benchmarkUeNum = "10,100,1000,10000";
+    std::string benchmarkRbgNum = "25,100,275";
+    uint32_t benchmarkSlots = 2000;
+    bool checkIndexedPf = false;
+    // UE counts and simulated seconds of the traffic source benchmark
+    std::string sourceBenchmark;
+    double sourceBenchmarkTime = 10;
+
+    CommandLine cmd(__FILE__);
+    params.AddToCommandLine(cmd);
+    cmd.AddValue("sweep",
+                 "Parameter grid run as separate processes, e.g. \"scheduler=PF,RR;ueNum=5,10\"",
+                 sweep);
+    cmd.AddValue("jobs", "Maximum number of parallel sweep processes (0 = one per core)", jobs);
+    cmd.AddValue("decodeAnimation", "Print a binary animation trace as CSV and exit", decodeAnimation);
+    cmd.AddValue("exportKpiCsv", "Print a KPI time series file as CSV and exit", exportKpiCsv);
+    cmd.AddValue("scaling",
+                 "Run the scenario once per UE count, e.g. \"5,50,500,5000\", and report "
+                 "setup time, run time, events and peak RSS",
+                 scaling);
+    cmd.AddValue("replications",
+                 "Run N replications (RngRun=1..N) and report 95% confidence intervals",
+                 replications);
+    cmd.AddValue("compare",
+                 "Configurations compared by --replications on common random numbers, e.g. \"scheduler=PF,RR\"",
+                 compare);
+    cmd.AddValue("schedulerBenchmark",
+                 "Time the given schedulers, e.g. \"PF,RR\", on synthetic UEs and exit",
+                 schedulerBenchmark);
+    cmd.AddValue("benchmarkUeNum", "UE counts of the scheduler benchmark", benchmarkUeNum);
+    cmd.AddValue("benchmarkRbgNum", "RBG counts of the scheduler benchmark", benchmarkRbgNum);
+    cmd.AddValue("benchmarkSlots", "Measured slots of every scheduler benchmark point", benchmarkSlots);
+    cmd.AddValue("checkIndexedPf",
+                 "Check that IndexedPF takes the same decisions as sorting every UE, on the benchmark "
+                 "UE and RBG counts, and exit",
+                 checkIndexedPf);
+    cmd.AddValue("sourceBenchmark",
+                 "Compare per-UE UdpClients with one MultiplexedUdpClient for the given UE counts, "
+                 "e.g. \"1000,10000\", without the NR stack, and exit",
+                 sourceBenchmark);
+    cmd.AddValue("sourceBenchmarkTime", "Simulated seconds of every source benchmark point", sourceBenchmarkTime);
+    cmd.Parse(argc, argv);
+
+    // Sweeps tag their points themselves; a single run without --simTag is
+    // named after its traffic model and scheduler so PF and RR runs do not
+    // overwrite each other's files
+    std::string sweepTag = params.simTag.empty() ? "sweep" : params.simTag;
+    if (params.simTag.empty())
+    {
+        params.simTag = params.GetDefaultSimTag();
+    }
+
+    if (!decodeAnimation.empty())
+    {
+        AnimationTraceSink::Decode(decodeAnimation, std::cout);
+        return EXIT_SUCCESS;
+    }
+
+    if (!exportKpiCsv.empty())
+    {
+        ColumnarWriter::ExportCsv(exportKpiCsv, std::cout);
+        return EXIT_SUCCESS;
+    }
+
+    // Compare the indexed PF scheduler with its reference, slot by slot
+    if (checkIndexedPf)
+    {
+        bool equivalent =
+            SchedulerBenchmark::CheckIndexedPf(benchmarkUeNum, benchmarkRbgNum, benchmarkSlots, std::cout);
+        return equivalent ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Drive the schedulers directly, without the rest of the simulation
+    if (!schedulerBenchmark.empty())
+    {
+        auto results =
+            SchedulerBenchmark::RunSuite(schedulerBenchmark, benchmarkUeNum, benchmarkRbgNum, benchmarkSlots);
+        SchedulerBenchmark::PrintTable(std::cout, results);
+        return EXIT_SUCCESS;
+    }
+
+    // Drive the downlink traffic sources alone, with the size and rate of the scenario
+    if (!sourceBenchmark.empty())
+    {
+        auto results = TrafficSourceBenchmark::RunSuite(sourceBenchmark,
+                                                        params.udpPacketSizeBe,
+                                                        Seconds(5000.0 / params.lambdaBe),
+                                                        Seconds(sourceBenchmarkTime));
+        TrafficSourceBenchmark::PrintTable(std::cout, results);
+        return EXIT_SUCCESS;
+    }
+
+    // Fan the grid out over the local cores and merge the results
+    if (!sweep.empty())
+    {
+        SweepRunner runner(argc, argv);
+        runner.SetGrid(sweep);
+        runner.SetJobs(jobs);
+        runner.SetOutput(params.outputDir, sweepTag);
+        runner.SetDefaultArgument("resultsTag", sweepTag);
+        return runner.Run();
+    }
+
+    // Measure how setup, run time and memory grow with the number of UEs.
+    // One process at a time unless --jobs says otherwise, so the timings do
+    // not compete for cores and memory bandwidth. The single socket source
+    // unless given, as the ephemeral port of every per-UE UdpClient socket
+    // is picked by scanning all the ports bound before it
+    if (!scaling.empty())
+    {
+        SweepRunner runner(argc, argv);
+        runner.SetGrid("ueNum=" + scaling);
+        runner.SetJobs(jobs > 0 ? jobs : 1);
+        runner.SetDefaultArgument("profile", "fast");
+        runner.SetDefaultArgument("source", "mux");
+        runner.SetOutput(params.outputDir, sweepTag + "-scaling");
+        runner.SetDefaultArgument("resultsTag", sweepTag + "-scaling");
+        runner.SetDefaultArgument("memoryInterval", "1");
+        int status = runner.Run();
+        runner.PrintTable(std::cout,
+                          {"ueNum",
+                           "setupWallTimeS",
+                           "setupScenarioS",
+                           "setupBandsS",
+                           "setupDevicesS",
+                           "setupCoreS",
+                           "setupRoutingS",
+                           "setupAttachS",
+                           "setupApplicationsS",
+                           "setupBearersS",
+                           "setupMonitoringS",
+                           "runWallTimeS",
+                           "eventsProcessed",
+                           "eventsPerSecond",
+                           "peakRssMiB",
+                           "peakHeapMiB",
+                           "liveObjects"});
+        return status;
+    }
+
+    // The adaptive run length works on the KPI time series
+    if (params.targetPrecision > 0 && params.kpiInterval <= 0)
+    {
+        params.kpiInterval = 0.1;
+    }
+
+    // Split the run over MPI ranks if asked to, before any node is created
+    NS_ABORT_MSG_IF(params.distributed && params.p2pDelay <= 0,
+                    "--distributed needs a positive --p2pDelay as lookahead");
+    NS_ABORT_MSG_IF(params.distributed && params.kpiInterval > 0,
+                    "The KPI sampler needs the flows of all the nodes and is not available with --distributed");
+    DistributedRun distributed(params.distributed, &argc, &argv);
+
+    // Wrap every event to find the hot spots of the run
+    if (params.eventProfile)
+    {
+        NS_ABORT_MSG_IF(params.distributed, "--eventProfile is not available with --distributed");
+        GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::ProfilingSimulatorImpl"));
+    }
+
+    // Run independent replications, with the same RngRun values for every
+    // compared configuration so that their differences can be paired
+    if (replications > 0)
+    {
+        std::string runs;
+        for (uint32_t run = 1; run <= replications; ++run)
+        {
+            runs += (run > 1 ? "," : "") + std::to_string(run);
+        }
+        SweepRunner runner(argc, argv);
+        runner.SetGrid(compare.empty() ? "RngRun=" + runs : compare + ";RngRun=" + runs);
+        runner.SetJobs(jobs);
+        runner.SetDefaultArgument("profile", "fast");
+        runner.SetOutput(params.outputDir, sweepTag + "-replications");
+        runner.SetDefaultArgument("resultsTag", sweepTag + "-replications");
+        runner.SetDefaultArgument("packetDelay", "true");
+        int status = runner.Run();
+        ReplicationReport report(runner.GetPoints(),
+                                 "RngRun",
+                                 {{"meanThroughputMbps", "Mean throughput (Mbps)"},
+                                  {"meanDelayMs", "Mean delay (ms)"},
+                                  {"packetDelayP50Ms", "Delay p50 (ms)"},
+                                  {"packetDelayP99Ms", "Delay p99 (ms)"},
+                                  {"packetLossRate", "Packet loss rate (%)"},
+                                  {"fairnessIndex", "Fairness index"}});
+        report.Print(std::cout);
+        return status;
+    }
+
+    // Select the debug features of this run and start timing the setup
+    RunProfile profile(params.profile);
+
+    // Check for invalid frequency values: the 38.901 channel model covers 0.5-100 GHz,
+    // for the low latency preset too (its original programs let up to 400 GHz through)
+    NS_ABORT_IF(params.centralFrequencyBand1 < 0.5e9 || params.centralFrequencyBand1 > 100e9);
+    NS_ABORT_IF(params.centralFrequencyBand2 < 0.5e9 || params.centralFrequencyBand2 > 100e9);
+
+    // Enable logging for specific components if logging is enabled
+    if (params.logging)
+    {
+        LogComponentEnable("UdpClient", LOG_LEVEL_INFO);
+        LogComponentEnable("UdpServer", LOG_LEVEL_INFO);
+        LogComponentEnable("LtePdcp", LOG_LEVEL_INFO);
+    }
+
+    // Set default max TX buffer size for LteRlcUm; bounded queues are
+    // enforced by the RLC queue manager, which counts the drops
+    Config::SetDefault("ns3::LteRlcUm::MaxTxBufferSize", UintegerValue(999999999));
+
+    // Set random stream and create a grid scenario with 1 row and gNbNum columns
+    profile.BeginPhase("scenario");
+    int64_t randomStream = 1;
+    GridScenarioHelper gridScenario;
+    gridScenario.SetRows(1);
+    gridScenario.SetColumns(params.gNbNum);
+
+    // Set horizontal and vertical distances between gNBs
+    gridScenario.SetHorizontalBsDistance(100.0);
+    gridScenario.SetVerticalBsDistance(10.0);
+    gridScenario.SetBsHeight(10);
+    gridScenario.SetUtHeight(1.5);
+
+    // Set sectorization and number of gNBs and UEs
+    gridScenario.SetSectorization(GridScenarioHelper::SINGLE);
+    gridScenario.SetBsNumber(params.gNbNum);
+    gridScenario.SetUtNumber(params.ueNum);
+
+    // Assign streams and create the scenario
+    randomStream += gridScenario.AssignStreams(randomStream);
+    gridScenario.CreateScenario();
+
+    // Generate the positions of the gNBs and the area the UEs move in
+    TopologyLayout layout = TopologyLayout::Generate(params.gNbNum, params.ueNum, params.gNbLayout, params.gNbSpacing);
+
+    // Create position and mobility for base stations (gNBs)
+    MobilityHelper bsMobility;
+    bsMobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    bsMobility.Install(gridScenario.GetBaseStations());
+    for (uint32_t i = 0; i < gridScenario.GetBaseStations().GetN(); ++i)
+    {
+        gridScenario.GetBaseStations().Get(i)->GetObject<MobilityModel>()->SetPosition(layout.gnbPositions[i]);
+    }
+
+    // Create node container for the UEs
+    NodeContainer ueContainer;
+    MobilityHelper ueMobility;
+    for (uint32_t j = 0; j < gridScenario.GetUserTerminals().GetN(); ++j)
+    {
+        Ptr<Node> ue = gridScenario.GetUserTerminals().Get(j);
+        ueContainer.Add(ue);
+    }
+
+    // Set up mobility for user terminals
+    ueMobility.SetPositionAllocator("ns3::GridPositionAllocator",
+                                    "MinX", DoubleValue(layout.ueOrigin.x),
+                                    "MinY", DoubleValue(layout.ueOrigin.y),
+                                    "DeltaX", DoubleValue(layout.ueSpacing),
+                                    "DeltaY", DoubleValue(layout.ueSpacing),
+                                    "GridWidth", UintegerValue(layout.ueGridWidth),
+                                    "LayoutType", StringValue("RowFirst"));
+    ueMobility.SetMobilityModel("ns3::RandomDirection2dMobilityModel",
+                                "Bounds", RectangleValue(layout.bounds),
+                                "Speed", StringValue("ns3::ConstantRandomVariable[Constant=2]"),
+                                "Pause", StringValue("ns3::ConstantRandomVariable[Constant=0.2]"));
+    ueMobility.Install(gridScenario.GetUserTerminals());
+
+    NS_LOG_INFO("Creating " << gridScenario.GetUserTerminals().GetN() << " user terminals and "
+                            << gridScenario.GetBaseStations().GetN() << " gNBs");
+
+    // Create the EPC network environment (PGW, SGW, and MME)
+    profile.BeginPhase("bands");
+    Ptr<NrPointToPointEpcHelper> epcHelper = CreateObject<NrPointToPointEpcHelper>();
+    Ptr<IdealBeamformingHelper> idealBeamformingHelper = CreateObject<IdealBeamformingHelper>();
+    Ptr<NrHelper> nrHelper = CreateObject<NrHelper>();
+
+    nrHelper->SetBeamformingHelper(idealBeamformingHelper);
+    nrHelper->SetEpcHelper(epcHelper);
+
+    // Create bandwidth part info vector
+    BandwidthPartInfoPtrVector allBwps;
+    CcBwpCreator ccBwpCreator;
+    const uint8_t numCcPerBand = 1;
+
+    // Create bandwidth 1 and 2 configurations
+    CcBwpCreator::SimpleOperationBandConf bandConf1(params.centralFrequencyBand1, params.bandwidthBand1, numCcPerBand, BandwidthPartInfo::UMi_StreetCanyon);
+    CcBwpCreator::SimpleOperationBandConf bandConf2(params.centralFrequencyBand2, params.bandwidthBand2, numCcPerBand, BandwidthPartInfo::UMi_StreetCanyon);
+
+    OperationBandInfo band1 = ccBwpCreator.CreateOperationBandContiguousCc(bandConf1);
+    OperationBandInfo band2 = ccBwpCreator.CreateOperationBandContiguousCc(bandConf2);
+
+    // Set up channel model and pathloss attributes
+    // A channel cache can only save regenerations the model would otherwise do
+    NS_ABORT_MSG_IF(params.channelCacheDistance > 0 && params.channelUpdatePeriod <= 0,
+                    "--channelCacheDistance needs a regenerating channel, set --channelUpdatePeriod");
+    Config::SetDefault("ns3::ThreeGppChannelModel::UpdatePeriod", TimeValue(MilliSeconds(params.channelUpdatePeriod)));
+    nrHelper->SetChannelConditionModelAttribute("UpdatePeriod", TimeValue(MilliSeconds(0)));
+    nrHelper->SetPathlossAttribute("ShadowingEnabled", BooleanValue(false));
+
+    // Initialize operation band 1
+    nrHelper->InitializeOperationBand(&band1);
+
+    double x = pow(20, params.totalTxPower / 5);
+    double totalBandwidth = params.bandwidthBand1;
+
+    if (params.doubleOperationalBand)
+    {
+        // Initialize operation band 2 if double operational band is enabled
+        nrHelper->InitializeOperationBand(&band2);
+        totalBandwidth += params.bandwidthBand2;
+        allBwps = CcBwpCreator::GetAllBwps({band1, band2});
+    }
+    else
+    {
+        allBwps = CcBwpCreator::GetAllBwps({band1});
+    }
+
+    // Enable packet checking and printing, only in the debug profile
+    profile.ApplyPacketSettings();
+
+    // Set beamforming method to Direct Path Beamforming, recomputed only on
+    // significant direction changes if a threshold is given; the incremental
+    // version with a zero threshold is the same algorithm, timed
+    if (params.beamAngleThreshold > 0 || params.beamStats)
+    {
+        idealBeamformingHelper->SetAttribute("BeamformingMethod",
+                                             TypeIdValue(IncrementalDirectPathBeamforming::GetTypeId()));
+        idealBeamformingHelper->SetBeamformingAlgorithmAttribute("AngleThreshold",
+                                                                 DoubleValue(params.beamAngleThreshold));
+    }
+    else
+    {
+        idealBeamformingHelper->SetAttribute("BeamformingMethod", TypeIdValue(DirectPathBeamforming::GetTypeId()));
+    }
+    epcHelper->SetAttribute("S1uLinkDelay", TimeValue(MilliSeconds(0)));
+
+    // Set UE antenna attributes
+    nrHelper->SetUeAntennaAttribute("NumRows", UintegerValue(2));
+    nrHelper->SetUeAntennaAttribute("NumColumns", UintegerValue(4));
+    nrHelper->SetUeAntennaAttribute("AntennaElement", PointerValue(CreateObject<IsotropicAntennaModel>()));
+
+    // Set gNB antenna attributes
+    nrHelper->SetGnbAntennaAttribute("NumRows", UintegerValue(4));
+    nrHelper->SetGnbAntennaAttribute("NumColumns", UintegerValue(8));
+    nrHelper->SetGnbAntennaAttribute("AntennaElement", PointerValue(CreateObject<IsotropicAntennaModel>()));
+
+    // Set BWP ID for the traffic bearer
+    uint32_t bwpIdForTraffic = 0;
+    if (params.doubleOperationalBand)
+    {
+        bwpIdForTraffic = 1;
+    }
+
+    // Set BWP manager algorithm attributes for the traffic bearer
+    nrHelper->SetGnbBwpManagerAlgorithmAttribute(params.bearer, UintegerValue(bwpIdForTraffic));
+    nrHelper->SetUeBwpManagerAlgorithmAttribute(params.bearer, UintegerValue(bwpIdForTraffic));
+
+    // Set scheduler type
+    nrHelper->SetSchedulerTypeId(TypeId::LookupByName(params.GetSchedulerTypeName()));
+
+    // Install gNB and UE devices
+    profile.BeginPhase("devices");
+    NetDeviceContainer enbNetDev = nrHelper->InstallGnbDevice(gridScenario.GetBaseStations(), allBwps);
+    NetDeviceContainer ueNetDev = nrHelper->InstallUeDevice(ueContainer, allBwps);
+
+    // Assign streams to devices
+    randomStream += nrHelper->AssignStreams(enbNetDev, randomStream);
+    randomStream += nrHelper->AssignStreams(ueNetDev, randomStream);
+
+    // Bound the downlink RLC queues and trace their occupancy, from the first bearer on
+    std::unique_ptr<RlcQueueManager> rlcQueues;
+    if (params.rlcMaxBytes > 0 || params.rlcMaxPackets > 0 || params.rlcAqm != "none" || params.rlcQueueStats)
+    {
+        rlcQueues = std::make_unique<RlcQueueManager>(params.rlcMaxBytes,
+                                                      params.rlcMaxPackets,
+                                                      params.rlcAqm,
+                                                      MilliSeconds(params.rlcAqmTarget),
+                                                      MilliSeconds(params.rlcAqmInterval));
+        rlcQueues->Install(enbNetDev);
+    }
+
+    // Reuse the channel matrices of slowly moving UEs, one cache per BWP; with
+    // --channelStats alone the wrappers only count the generations
+    std::vector<Ptr<CachedChannelModel>> channelCaches;
+    if (params.channelCacheDistance > 0 || params.channelStats)
+    {
+        for (const auto& bwp : allBwps)
+        {
+            Ptr<ThreeGppSpectrumPropagationLossModel> spectrumLoss =
+                DynamicCast<ThreeGppSpectrumPropagationLossModel>(bwp.get()->m_3gppChannel);
+            NS_ABORT_MSG_IF(!spectrumLoss, "The channel cache needs the 3GPP spectrum propagation loss model");
+            Ptr<CachedChannelModel> cache = CreateObject<CachedChannelModel>();
+            cache->SetAttribute("Enabled", BooleanValue(params.channelCacheDistance > 0));
+            cache->SetAttribute("Distance", DoubleValue(params.channelCacheDistance));
+            cache->SetAttribute("CoherenceTime", TimeValue(Seconds(params.channelCacheCoherenceTime)));
+            cache->SetAttribute("CheckAccuracy", BooleanValue(params.channelCacheCheck));
+            cache->SetChannelModel(spectrumLoss->GetChannelModel());
+            spectrumLoss->SetChannelModel(cache);
+            channelCaches.push_back(cache);
+        }
+    }
+
+    // Configure gNB PHY attributes, the second band only if double operational band is enabled
+    for (uint32_t i = 0; i < enbNetDev.GetN(); ++i)
+    {
+        nrHelper->GetGnbPhy(enbNetDev.Get(i), 0)->SetAttribute("Numerology", UintegerValue(params.numerologyBwp1));
+        nrHelper->GetGnbPhy(enbNetDev.Get(i), 0)->SetAttribute("TxPower", DoubleValue(10 * log10((params.bandwidthBand1 / totalBandwidth) * x)));
+        if (params.doubleOperationalBand)
+        {
+            nrHelper->GetGnbPhy(enbNetDev.Get(i), 1)->SetAttribute("Numerology", UintegerValue(params.numerologyBwp2));
+            nrHelper->GetGnbPhy(enbNetDev.Get(i), 1)->SetTxPower(10 * log10((params.bandwidthBand2 / totalBandwidth) * x));
+        }
+    }
+
+    // Update device configurations
+    for (auto it = enbNetDev.Begin(); it != enbNetDev.End(); ++it)
+    {
+        DynamicCast<NrGnbNetDevice>(*it)->UpdateConfig();
+    }
+
+    for (auto it = ueNetDev.Begin(); it != ueNetDev.End(); ++it)
+    {
+        DynamicCast<NrUeNetDevice>(*it)->UpdateConfig();
+    }
+
+    // Collect the per slot scheduling statistics of every carrier in memory
+    std::unique_ptr<MacSlotStats> macSlotStats;
+    if (params.macSlotStats)
+    {
+        macSlotStats = std::make_unique<MacSlotStats>(params.macSlotStatsSlots);
+        macSlotStats->Install(enbNetDev);
+    }
+
+    // And the link quality each UE sees, for its flow
+    std::unique_ptr<LinkQualityProbe> linkQuality;
+    if (params.linkQuality)
+    {
+        linkQuality = std::make_unique<LinkQualityProbe>();
+        linkQuality->Install(ueNetDev, enbNetDev);
+    }
+
+    // Set up PGW node
+    profile.BeginPhase("core");
+    Ptr<Node> pgw = epcHelper->GetPgwNode();
+    MobilityHelper pgwMobility;
+    Ptr<ListPositionAllocator> positionAllocPgw = CreateObject<ListPositionAllocator>();
+    positionAllocPgw->Add(Vector(70.0, 0.0, 1.5));
+    pgwMobility.SetPositionAllocator(positionAllocPgw);
+    pgwMobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    pgwMobility.Install(pgw);
+
+    // Set up SGW node
+    Ptr<Node> sgw = epcHelper->GetSgwNode();
+    MobilityHelper sgwMobility;
+    Ptr<ListPositionAllocator> positionAllocSgw = CreateObject<ListPositionAllocator>();
+    positionAllocSgw->Add(Vector(50.0, 0.0, 1.5));
+    sgwMobility.SetPositionAllocator(positionAllocSgw);
+    sgwMobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    sgwMobility.Install(sgw);
+
+    // Set up MME node
+    Ptr<Node> mme = epcHelper->GetMmeNode();
+    MobilityHelper MmeMobility;
+    Ptr<ListPositionAllocator> positionAllocMme = CreateObject<ListPositionAllocator>();
+    positionAllocMme->Add(Vector(40.0, 0.0, 1.5));
+    MmeMobility.SetPositionAllocator(positionAllocMme);
+    MmeMobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    MmeMobility.Install(mme);
+
+    // Create a remote host node
+    NodeContainer remoteHostContainer;
+    remoteHostContainer.Create(1, distributed.GetRemoteHostRank());
+    Ptr<Node> remoteHost = remoteHostContainer.Get(0);
+
+    // Install Internet stack on remote host
+    InternetStackHelper internet;
+    internet.Install(remoteHostContainer);
+
+    // Set up remote host mobility
+    MobilityHelper remoteHostMobility;
+    Ptr<ListPositionAllocator> positionAllocRemoteHost = CreateObject<ListPositionAllocator>();
+    positionAllocRemoteHost->Add(Vector(90.0, 0.0, 1.5));
+    remoteHostMobility.SetPositionAllocator(positionAllocRemoteHost);
+    remoteHostMobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    remoteHostMobility.Install(remoteHost);
+
+    // Create a point-to-point connection between PGW and remote host
+    PointToPointHelper p2ph;
+    p2ph.SetDeviceAttribute("DataRate", DataRateValue(DataRate("100Gb/s")));
+    p2ph.SetDeviceAttribute("Mtu", UintegerValue(2500));
+    p2ph.SetChannelAttribute("Delay", TimeValue(Seconds(params.p2pDelay)));
+    NetDeviceContainer internetDevices = p2ph.Install(pgw, remoteHost);
+
+    // Assign IP addresses to the point-to-point connection
+    Ipv4AddressHelper ipv4h;
+    Ipv4StaticRoutingHelper ipv4RoutingHelper;
+
+    ipv4h.SetBase("1.0.0.0", "255.0.0.0");
+    Ipv4InterfaceContainer internetIpIfaces = ipv4h.Assign(internetDevices);
+
+    Ptr<Ipv4StaticRouting> remoteHostStaticRouting = ipv4RoutingHelper.GetStaticRouting(remoteHost->GetObject<Ipv4>());
+    remoteHostStaticRouting->AddNetworkRouteTo(Ipv4Address("7.0.0.0"), Ipv4Mask("255.0.0.0"), 1);
+
+    // Install Internet stack on user terminals
+    internet.Install(gridScenario.GetUserTerminals());
+
+    // Assign IP addresses to UEs
+    Ipv4InterfaceContainer ueIpIface = epcHelper->AssignUeIpv4Address(NetDeviceContainer(ueNetDev));
+
+    // Set up default routes for UEs, all through the same gateway
+    profile.BeginPhase("routing");
+    Ipv4Address ueGateway = epcHelper->GetUeDefaultGatewayAddress();
+    for (uint32_t j = 0; j < ueContainer.GetN(); ++j)
+    {
+        ipv4RoutingHelper.GetStaticRouting(ueContainer.Get(j)->GetObject<Ipv4>())->SetDefaultRoute(ueGateway, 1);
+    }
+
+    // Attach UEs to gNBs, alternating between them or to the closest one
+    profile.BeginPhase("attach");
+    if (params.attach == "closest")
+    {
+        nrHelper->AttachToClosestEnb(ueNetDev, enbNetDev);
+    }
+    else
+    {
+        NS_ABORT_MSG_IF(params.attach != "alternate",
+                        "Unknown attachment " << params.attach << " (expected alternate or closest)");
+        for (uint32_t i = 0; i < ueNetDev.GetN(); ++i)
+        {
+            nrHelper->AttachToEnb(ueNetDev.Get(i), enbNetDev.Get(i % enbNetDev.GetN()));
+        }
+    }
+
+    // Set up the downlink client and server applications, on the nodes of this rank only
+    profile.BeginPhase("applications");
+    NS_ABORT_MSG_IF(params.source != "udp" && params.source != "mux" && params.source != "trace" &&
+                        params.source != "voip" && params.source != "urllc",
+                    "Unknown source " << params.source << " (expected udp, mux, trace, voip or urllc)");
+    NS_ABORT_MSG_IF(params.source == "trace" && params.traceFile.empty(), "--source=trace needs a --traceFile");
+    ApplicationContainer serverApps;
+    UdpServerHelper dlPacketSink(params.dlPort);
+    UrllcHelper urllc;
+    for (uint32_t i = 0; i < ueContainer.GetN(); ++i)
+    {
+        if (distributed.IsLocal(ueContainer.Get(i)) && params.source == "urllc")
+        {
+            serverApps.Add(urllc.InstallSink(ueContainer.Get(i), params.dlPort));
+        }
+        else if (distributed.IsLocal(ueContainer.Get(i)))
+        {
+            serverApps.Add(dlPacketSink.Install(ueContainer.Get(i)));
+        }
+    }
+
+    UdpClientHelper dlClient;
+    dlClient.SetAttribute("RemotePort", UintegerValue(params.dlPort));
+    dlClient.SetAttribute("MaxPackets", UintegerValue(0xFFFFFFFF));
+    dlClient.SetAttribute("PacketSize", UintegerValue(params.udpPacketSizeBe));
+    dlClient.SetAttribute("Interval", TimeValue(Seconds(5000.0 / params.lambdaBe)));
+
+    // Or the same flows from a single application, socket and timing wheel
+    Ptr<MultiplexedUdpClient> muxClient;
+    if (distributed.IsLocal(remoteHost) && params.source == "mux")
+    {
+        muxClient = CreateObject<MultiplexedUdpClient>();
+        muxClient->SetAttribute("RemotePort", UintegerValue(params.dlPort));
+        muxClient->SetAttribute("MaxPackets", UintegerValue(0xFFFFFFFF));
+        muxClient->SetAttribute("PacketSize", UintegerValue(params.udpPacketSizeBe));
+        muxClient->SetAttribute("Interval", TimeValue(Seconds(5000.0 / params.lambdaBe)));
+    }
+
+    // Or a packet trace replayed over the UEs
+    Ptr<TraceReplayClient> traceClient;
+    if (distributed.IsLocal(remoteHost) && params.source == "trace")
+    {
+        traceClient = CreateObject<TraceReplayClient>();
+        traceClient->SetAttribute("RemotePort", UintegerValue(params.dlPort));
+        traceClient->SetAttribute("TraceFile", StringValue(params.traceFile));
+        traceClient->SetAttribute("Format", StringValue(params.traceFormat));
+    }
+
+    // Or a voice codec model in place of the fixed size, fixed rate client
+    VoipSourceHelper voipSource;
+    voipSource.SetAttribute("RemotePort", UintegerValue(params.dlPort));
+    voipSource.SetCodec(params.voipCodec);
+
+    // Or URLLC bursts with a delivery deadline per packet
+    NS_ABORT_MSG_IF(params.urllcArrival != "poisson" && params.urllcArrival != "periodic",
+                    "Unknown URLLC arrival " << params.urllcArrival << " (expected poisson or periodic)");
+    urllc.SetSourceAttribute("PacketSize", UintegerValue(params.urllcPacketSize));
+    urllc.SetSourceAttribute("BurstSize", UintegerValue(params.urllcBurstSize));
+    urllc.SetSourceAttribute("Interval", TimeValue(MilliSeconds(params.urllcInterval)));
+    urllc.SetSourceAttribute("Poisson", BooleanValue(params.urllcArrival == "poisson"));
+    urllc.SetSourceAttribute("Deadline", TimeValue(MilliSeconds(params.urllcDeadline)));
+
+    // Install the downlink clients on the remote host, one pass over the UEs for the selected source
+    ApplicationContainer clientApps;
+    bool localClients = distributed.IsLocal(remoteHost);
+    if (localClients && params.source == "voip")
+    {
+        for (uint32_t i = 0; i < ueContainer.GetN(); ++i)
+        {
+            voipSource.SetAttribute("RemoteAddress", AddressValue(ueIpIface.GetAddress(i)));
+            clientApps.Add(voipSource.Install(remoteHost));
+        }
+    }
+    else if (localClients && params.source == "urllc")
+    {
+        for (uint32_t i = 0; i < ueContainer.GetN(); ++i)
+        {
+            clientApps.Add(urllc.InstallSource(remoteHost, ueIpIface.GetAddress(i), params.dlPort));
+        }
+    }
+    else if (muxClient)
+    {
+        for (uint32_t i = 0; i < ueContainer.GetN(); ++i)
+        {
+            muxClient->AddDestination(ueIpIface.GetAddress(i));
+        }
+        remoteHost->AddApplication(muxClient);
+        clientApps.Add(muxClient);
+    }
+    else if (traceClient)
+    {
+        for (uint32_t i = 0; i < ueContainer.GetN(); ++i)
+        {
+            traceClient->AddDestination(ueIpIface.GetAddress(i));
+        }
+        remoteHost->AddApplication(traceClient);
+        clientApps.Add(traceClient);
+    }
+    else if (localClients)
+    {
+        for (uint32_t i = 0; i < ueContainer.GetN(); ++i)
+        {
+            dlClient.SetAttribute("RemoteAddress", AddressValue(ueIpIface.GetAddress(i)));
+            clientApps.Add(dlClient.Install(remoteHost));
+        }
+    }
+    randomStream += VoipSourceHelper::AssignStreams(clientApps, randomStream);
+    randomStream += UrllcHelper::AssignStreams(clientApps, randomStream);
+
+    // Start and stop the server and client applications
+    serverApps.Start(Seconds(params.udpAppStartTime));
+    clientApps.Start(Seconds(params.udpAppStartTime));
+    serverApps.Stop(Seconds(params.simTime));
+    clientApps.Stop(Seconds(params.simTime));
+
+    // Create the dedicated EPS bearer carrying the traffic
+    profile.BeginPhase("bearers");
+    EpsBearer trafficBearer(params.GetBearerQci());
+
+    // Create a Traffic Flow Template (TFT) matching the downlink port
+    Ptr<EpcTft> trafficTft = Create<EpcTft>();
+    EpcTft::PacketFilter dlpf;
+    dlpf.localPortStart = params.dlPort;
+    dlpf.localPortEnd = params.dlPort;
+    trafficTft->Add(dlpf);
+
+    // Activate it on all the UE devices at once
+    nrHelper->ActivateDedicatedEpsBearer(ueNetDev, trafficBearer, trafficTft);
+
+    // Create a flow monitor on the endpoint nodes
+    profile.BeginPhase("monitoring");
+    FlowMonitorHelper flowmonHelper;
+    NodeContainer endpointNodes;
+    endpointNodes.Add(remoteHost);
+    endpointNodes.Add(gridScenario.GetUserTerminals());
+
+    Ptr<ns3::FlowMonitor> monitor = flowmonHelper.Install(endpointNodes);
+    monitor->SetAttribute("DelayBinWidth", DoubleValue(params.delayBinWidth));
+    monitor->SetAttribute("JitterBinWidth", DoubleValue(params.delayBinWidth));
+    monitor->SetAttribute("PacketSizeBinWidth", DoubleValue(20));
+
+    // Measure per-packet delay and jitter at the UDP servers for the tail percentiles
+    std::unique_ptr<DelayProbe> delayProbe;
+    if (params.packetDelay)
+    {
+        delayProbe = std::make_unique<DelayProbe>(params.latencyPrecision);
+        delayProbe->Install(serverApps);
+    }
+
+    // Sample the per-flow KPIs periodically to see the transients
+    std::unique_ptr<KpiSampler> kpiSampler;
+    if (params.kpiInterval > 0)
+    {
+        kpiSampler = std::make_unique<KpiSampler>(monitor, params.GetOutputPath(".kpi"), Seconds(params.kpiInterval));
+        kpiSampler->Start(Seconds(params.udpAppStartTime), Seconds(params.simTime));
+    }
+
+    // Stop early once the KPIs have converged, simTime is then the maximum
+    std::unique_ptr<RunLengthController> runLength;
+    if (params.targetPrecision > 0)
+    {
+        runLength = std::make_unique<RunLengthController>(params.targetPrecision, Seconds(params.minSimTime));
+        runLength->Attach(*kpiSampler);
+    }
+
+    // Map each UE address to its node, to match flows with the delay probe
+    std::map<Ipv4Address, uint32_t> ueNodeByAddress;
+    for (uint32_t i = 0; i < ueContainer.GetN(); ++i)
+    {
+        ueNodeByAddress[ueIpIface.GetAddress(i)] = ueContainer.Get(i)->GetId();
+    }
+
+    // Set up the animation output, named after the run so parallel runs do not clobber it
+    Time animStop = Seconds(params.animStop > 0 ? params.animStop : params.simTime);
+    std::unique_ptr<AnimationInterface> anim;
+    std::unique_ptr<AnimationTraceSink> animSink;
+    bool animate = profile.IsAnimationEnabled() && distributed.IsReportingRank();
+    if (animate && params.animFormat == "xml")
+    {
+        anim = std::make_unique<AnimationInterface>(params.GetOutputPath(".xml"));
+        anim->SetStartTime(Seconds(params.animStart));
+        anim->SetStopTime(animStop);
+        anim->SetMobilityPollInterval(Seconds(params.animPollInterval));
+        // Enable packet metadata for the animation, only in the debug profile
+        anim->EnablePacketMetadata(profile.IsAnimationPacketMetadataEnabled());
+        if (params.animSampling > 1)
+        {
+            std::cout << "Packet sampling is only supported by --animFormat=binary\n";
+        }
+    }
+    else if (animate && params.animFormat == "binary")
+    {
+        animSink = std::make_unique<AnimationTraceSink>(params.GetOutputPath(".anim"));
+        animSink->SetTimeWindow(Seconds(params.animStart), animStop);
+        animSink->SetPacketSampling(params.animSampling);
+        animSink->SetMobilityPollInterval(Seconds(params.animPollInterval));
+        animSink->Install();
+    }
+    else if (animate)
+    {
+        NS_ABORT_MSG("Unknown animation format " << params.animFormat << " (expected xml or binary)");
+    }
+
+    // Update node descriptions and colors for the animation
+    auto labelNode = [&anim, &animSink](Ptr<Node> node, const std::string& description, uint8_t r, uint8_t g, uint8_t b) {
+        if (anim)
+        {
+            anim->UpdateNodeDescription(node, description);
+            anim->UpdateNodeColor(node, r, g, b);
+        }
+        if (animSink)
+        {
+            animSink->UpdateNodeDescription(node, description);
+            animSink->UpdateNodeColor(node, r, g, b);
+        }
+    };
+
+    for (uint32_t i = 0; i < ueContainer.GetN(); ++i)
+    {
+        labelNode(ueContainer.Get(i), "UE-" + std::to_string(i + 1), 0, 255, 0);
+    }
+
+    for (uint32_t i = 0; i < gridScenario.GetBaseStations().GetN(); ++i)
+    {
+        labelNode(gridScenario.GetBaseStations().Get(i), "gNB-" + std::to_string(i + 1), 255, 0, 0);
+    }
+
+    labelNode(pgw, "PGW", 255, 255, 0);
+    labelNode(sgw, "SGW", 255, 250, 0);
+    labelNode(mme, "MME", 255, 250, 0);
+    labelNode(remoteHost, "RH", 0, 0, 255);
+
+    // Account for the memory of the run, sampled periodically if asked
+    MemoryAccounting memory(monitor);
+    memory.SetAnimationSink(animSink.get());
+    memory.SetRlcQueues(rlcQueues.get());
+    for (const auto& cache : channelCaches)
+    {
+        memory.AddChannelCache(cache);
+    }
+    if (params.memoryInterval > 0)
+    {
+        memory.Start(params.GetOutputPath(".memory"),
+                     Seconds(params.udpAppStartTime),
+                     Seconds(params.memoryInterval),
+                     Seconds(params.simTime));
+    }
+
+    // Stop the simulation at the specified time
+    Simulator::Stop(Seconds(params.simTime));
+    profile.StartRun();
+    Simulator::Run();
+    profile.StopRun();
+
+    // Close the KPI time series and optionally convert it to CSV
+    if (kpiSampler)
+    {
+        kpiSampler->Finish();
+        if (params.kpiCsv)
+        {
+            std::ofstream csv(params.GetOutputPath("-kpi.csv"));
+            ColumnarWriter::ExportCsv(kpiSampler->GetPath(), csv);
+        }
+    }
+    memory.Finish();
+    profile.ExcludeFromRun(memory.GetSampleSeconds());
+
+    // Write the last slots and the histograms of the MAC scheduling statistics
+    if (macSlotStats)
+    {
+        macSlotStats->Export(params.GetOutputPath(".slots"), params.GetOutputPath("-mac-histograms.csv"));
+        if (params.kpiCsv)
+        {
+            std::ofstream csv(params.GetOutputPath("-slots.csv"));
+            ColumnarWriter::ExportCsv(params.GetOutputPath(".slots"), csv);
+        }
+    }
+    if (params.memoryInterval > 0 && params.kpiCsv)
+    {
+        std::ofstream csv(params.GetOutputPath("-memory.csv"));
+        ColumnarWriter::ExportCsv(memory.GetPath(), csv);
+    }
+
+    // Report the beams computed and skipped and the measured time of all the
+    // beamforming calls; the saving is the difference with a --beamStats run
+    if (params.beamAngleThreshold > 0 || params.beamStats)
+    {
+        auto beams = IncrementalDirectPathBeamforming::GetTotalStatistics();
+        std::cout << "Beamforming: " << beams.computed + beams.skipped << " calls, "
+                  << std::chrono::duration<double>(beams.callTime).count() * 1000 << " ms; " << beams.computed
+                  << " computed, " << beams.skipped << " skipped ("
+                  << (beams.computed + beams.skipped > 0 ? 100.0 * beams.skipped / (beams.computed + beams.skipped) : 0.0)
+                  << " %), " << beams.steeringVectors << " steering vectors cached\n";
+    }
+
+    // Report the channel matrix generations (the saving is their difference
+    // with a --channelStats run) and how far the reused matrices were off
+    if (!channelCaches.empty())
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t generations = 0;
+        double modelSeconds = 0.0;
+        uint64_t checks = 0;
+        double gainError = 0.0;
+        double maxGainError = 0.0;
+        double spread = 0.0;
+        for (const auto& cache : channelCaches)
+        {
+            hits += cache->GetHits();
+            misses += cache->GetMisses();
+            generations += cache->GetGenerations();
+            modelSeconds += cache->GetModelSeconds();
+            checks += cache->GetChecks();
+            gainError += cache->GetMeanGainError() * cache->GetChecks();
+            maxGainError = std::max(maxGainError, cache->GetMaxGainError());
+            spread += cache->GetMeanRealizationSpread() * cache->GetChecks();
+        }
+        std::cout << "Channel generations: " << generations << " matrices, " << modelSeconds
+                  << " s in the channel model\n";
+        if (params.channelCacheDistance > 0)
+        {
+            std::cout << "Channel cache: " << hits << " hits, " << misses << " misses ("
+                      << (hits + misses > 0 ? 100.0 * hits / (hits + misses) : 0.0) << " % hit rate)\n";
+        }
+        if (params.channelCacheCheck && checks > 0)
+        {
+            std::cout << "Channel cache error: " << checks << " hits checked, beamformed gain "
+                      << gainError / checks << " dB mean, " << maxGainError << " dB max (fresh against fresh "
+                      << spread / checks << " dB)\n";
+        }
+    }
+
+    // Flush the binary animation trace while the simulator is still alive
+    if (animSink)
+    {
+        animSink->Finish();
+        std::cout << "Animation trace: " << animSink->GetRecords() << " records, "
+                  << animSink->GetBytesWritten() << " bytes\n";
+    }
+
+    // Only rank 0 has the receivers and reports the results
+    if (!distributed.IsReportingRank())
+    {
+        Simulator::Destroy();
+        return EXIT_SUCCESS;
+    }
+
+    // Calculate the duration of the flow, up to where the run actually stopped
+    double flowDuration = (Simulator::Now() - Seconds(params.udpAppStartTime)).GetSeconds();
+
+    std::cout << "Scenario: " << params.traffic << ", scheduler " << params.GetSchedulerTypeName()
+              << ", bearer " << params.bearer << ", " << params.gNbNum << " gNBs, "
+              << params.ueNum << " UEs\n";
+
+    // Structured records of the flows and the run, tagged with every parameter
+    std::unique_ptr<ResultsWriter> results;
+    if (params.results != "none" || !params.runRecord.empty())
+    {
+        ResultsWriter::Tags tags = params.GetValues();
+        tags.emplace_back("schedulerTypeId", params.GetSchedulerTypeName());
+        tags.emplace_back("rngSeed", std::to_string(RngSeedManager::GetSeed()));
+        tags.emplace_back("rngRun", std::to_string(RngSeedManager::GetRun()));
+        results = std::make_unique<ResultsWriter>(params.results != "none" ? params.results : "csv", tags);
+    }
+    double meanThroughput = std::nan("");
+    double meanDelay = std::nan("");
+    double packetLossRate = std::nan("");
+    double fairnessIndex = std::nan("");
+    uint32_t totalFlows = 0;
+
+    // Per-flow FlowMonitor statistics, which need both ends of every flow on
+    // this rank and are therefore skipped in a distributed run
+    if (!distributed.IsEnabled())
+    {
+        // Check for lost packets and retrieve flow statistics
+        monitor->CheckForLostPackets();
+        Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowmonHelper.GetClassifier());
+        FlowMonitor::FlowStatsContainer stats = monitor->GetFlowStats();
+
+        // Initialize variables to track total statistics
+        double totalRxBytes = 0.0;
+        double totalDelay = 0.0;
+        double totalLostPackets = 0.0;
+        uint32_t totalRxPackets = 0;
+        uint32_t totalTxPackets = 0;
+        std::vector<const Histogram*> delayHistograms;
+        std::vector<const Histogram*> jitterHistograms;
+
+        // Iterate over the flow statistics
+        for (auto i = stats.begin(); i != stats.end(); ++i)
+        {
+            // Get the 5-tuple for the current flow
+            Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(i->first);
+
+            // Print the flow information
+            std::cout << "\nFlow " << i->first << " (" << t.sourceAddress << ":" << t.sourcePort << " -> "
+                      << t.destinationAddress << ":" << t.destinationPort << ") proto "
+                      << (t.protocol == 6 ? "TCP" : "UDP") << "\n";
+            std::cout << "  Tx Packets: " << i->second.txPackets << "\n";
+            std::cout << "  Tx Bytes:   " << i->second.txBytes << "\n";
+            std::cout << "  TxOffered:  " << i->second.txBytes * 8.0 / flowDuration / 1000.0 / 1000.0
+                      << " Mbps\n";
+            std::cout << "  Rx Bytes:   " << i->second.rxBytes << "\n";
+
+            // Calculate and print flow statistics if there are received packets
+            if (i->second.rxPackets > 0)
+            {
+                double throughput = i->second.rxBytes * 8.0 / flowDuration / 1000 / 1000;
+                double delay = 1000 * i->second.delaySum.GetSeconds() / i->second.rxPackets;
+                double lossRate = (i->second.txPackets - i->second.rxPackets) * 100.0 / i->second.txPackets;
+
+                std::cout << "  Throughput: " << throughput << " Mbps\n";
+                std::cout << "  Mean delay:  " << delay << " ms\n";
+                std::cout << "  Packet loss rate:  " << lossRate << " %\n";
+
+                // Print the tail latency from the FlowMonitor histograms and the per-packet sketches
+                PrintPercentiles(std::cout, "  Delay", {&i->second.delayHistogram});
+                PrintPercentiles(std::cout, "  Jitter", {&i->second.jitterHistogram});
+                auto ueNode = ueNodeByAddress.find(t.destinationAddress);
+                if (delayProbe && ueNode != ueNodeByAddress.end() && delayProbe->GetDelay(ueNode->second))
+                {
+                    PrintPercentiles(std::cout, "  Packet delay", *delayProbe->GetDelay(ueNode->second));
+                    PrintPercentiles(std::cout, "  Packet jitter", *delayProbe->GetJitter(ueNode->second));
+                }
+                delayHistograms.push_back(&i->second.delayHistogram);
+                jitterHistograms.push_back(&i->second.jitterHistogram);
+
+                // Update the total statistics
+                totalRxBytes += i->second.rxBytes;
+                totalDelay += i->second.delaySum.GetSeconds();
+                totalLostPackets += (i->second.txPackets - i->second.rxPackets);
+                totalRxPackets += i->second.rxPackets;
+                totalTxPackets += i->second.txPackets;
+                totalFlows++;
+            }
+            else
+            {
+                std::cout << "  Throughput:  0 Mbps\n";
+                std::cout << "  Mean delay:  0 ms\n";
+                std::cout << "  Packet loss rate:  100 %\n";
+            }
+            std::cout << "  Rx Packets: " << i->second.rxPackets << "\n";
+            auto linkNode = ueNodeByAddress.find(t.destinationAddress);
+            if (linkQuality && linkNode != ueNodeByAddress.end())
+            {
+                linkQuality->PrintUe(std::cout, linkNode->second);
+            }
+
+            if (results)
+            {
+                std::ostringstream source;
+                std::ostringstream destination;
+                source << t.sourceAddress;
+                destination << t.destinationAddress;
+                results->BeginRecord("flow");
+                results->Add("flowId", i->first);
+                results->Add("sourceAddress", source.str());
+                results->Add("sourcePort", static_cast<uint32_t>(t.sourcePort));
+                results->Add("destinationAddress", destination.str());
+                results->Add("destinationPort", static_cast<uint32_t>(t.destinationPort));
+                results->Add("protocol", std::string(t.protocol == 6 ? "TCP" : "UDP"));
+                results->Add("txPackets", i->second.txPackets);
+                results->Add("txBytes", i->second.txBytes);
+                results->Add("txOfferedMbps", i->second.txBytes * 8.0 / flowDuration / 1000.0 / 1000.0);
+                results->Add("rxPackets", i->second.rxPackets);
+                results->Add("rxBytes", i->second.rxBytes);
+                bool received = i->second.rxPackets > 0;
+                results->Add("throughputMbps", i->second.rxBytes * 8.0 / flowDuration / 1000 / 1000);
+                results->Add("meanDelayMs",
+                             received ? 1000 * i->second.delaySum.GetSeconds() / i->second.rxPackets : 0.0);
+                results->Add("packetLossRate",
+                             i->second.txPackets > 0
+                                 ? (i->second.txPackets - i->second.rxPackets) * 100.0 / i->second.txPackets
+                                 : 100.0);
+                results->EndRecord();
+            }
+        }
+
+        // Calculate overall statistics
+        meanThroughput = totalRxBytes * 8.0 / (flowDuration * totalFlows) / 1000 / 1000;
+        meanDelay = totalDelay / totalRxPackets * 1000;
+        packetLossRate = totalLostPackets * 100.0 / totalTxPackets;
+
+        // Calculate the fairness index if there are multiple flows
+        fairnessIndex = 0.0;
+        if (totalFlows > 1)
+        {
+            double sumThroughput = 0.0;
+            double sumThroughputSq = 0.0;
+            for (auto i = stats.begin(); i != stats.end(); ++i)
+            {
+                if (i->second.rxPackets > 0)
+                {
+                    double throughput = i->second.rxBytes * 8.0 / flowDuration / 1000 / 1000;
+                    sumThroughput += throughput;
+                    sumThroughputSq += throughput * throughput;
+                }
+            }
+            // Jain's fairness index
+            fairnessIndex = (sumThroughput * sumThroughput) / (totalFlows * sumThroughputSq);
+        }
+
+        // Print overall statistics
+        std::cout << "\n\n  Mean throughput: " << meanThroughput << " Mbps\n";
+        std::cout << "  Mean delay: " << meanDelay << " ms\n";
+        std::cout << "  Packet loss rate: " << packetLossRate << " %\n";
+        std::cout << "  Fairness index: " << fairnessIndex << "\n";
+        PrintPercentiles(std::cout, "  Delay", delayHistograms);
+        PrintPercentiles(std::cout, "  Jitter", jitterHistograms);
+        if (runLength)
+        {
+            std::cout << "  (FlowMonitor totals, including the warm-up up to " << runLength->GetWarmupEnd().GetSeconds()
+                      << " s; see Steady state below)\n";
+        }
+    }
+
+    // Application level summary from the UDP servers (or URLLC sinks), complete on rank 0
+    // in a distributed run too; compare it with a sequential run with the same p2pDelay
+    uint64_t appRxPackets = 0;
+    uint64_t appLostPackets = 0;
+    for (uint32_t i = 0; i < serverApps.GetN(); ++i)
+    {
+        if (Ptr<UdpServer> server = DynamicCast<UdpServer>(serverApps.Get(i)))
+        {
+            appRxPackets += server->GetReceived();
+            appLostPackets += server->GetLost();
+        }
+        else if (Ptr<UrllcSink> sink = DynamicCast<UrllcSink>(serverApps.Get(i)))
+        {
+            appRxPackets += sink->GetReceived();
+            appLostPackets += sink->GetLost();
+        }
+    }
+    std::cout << "  App received packets: " << appRxPackets << "\n";
+    std::cout << "  App lost packets: " << appLostPackets << "\n";
+    LatencySketch appDelay(params.latencyPrecision);
+    if (delayProbe)
+    {
+        appDelay = delayProbe->GetAggregateDelay();
+        std::cout << "  App throughput: "
+                  << delayProbe->GetReceivedBytes() * 8.0 / flowDuration / 1000 / 1000 << " Mbps\n";
+        std::cout << "  App mean delay: " << appDelay.GetMean().GetSeconds() * 1000 << " ms\n";
+        PrintPercentiles(std::cout, "  Packet delay", appDelay);
+        PrintPercentiles(std::cout, "  Packet jitter", delayProbe->GetAggregateJitter());
+    }
+    if (params.source == "urllc")
+    {
+        UrllcHelper::PrintSummary(std::cout, serverApps);
+    }
+    if (rlcQueues)
+    {
+        rlcQueues->Report(std::cout, params.rlcQueueStats);
+    }
+    if (macSlotStats)
+    {
+        macSlotStats->Report(std::cout);
+    }
+    if (linkQuality)
+    {
+        linkQuality->Report(std::cout);
+    }
+
+    if (runLength)
+    {
+        runLength->Report(std::cout);
+    }
+
+    // Print the wall time and event rate of this profile, and where the memory went
+    profile.Report(std::cout);
+    MemoryAccounting::Snapshot memoryUse = memory.TakeSnapshot();
+    memory.Report(std::cout, memoryUse);
+
+    if (results)
+    {
+        results->BeginRecord("run");
+        results->Add("flowDurationS", flowDuration);
+        results->Add("flows", totalFlows);
+        results->Add("meanThroughputMbps", meanThroughput);
+        results->Add("meanDelayMs", meanDelay);
+        results->Add("packetLossRate", packetLossRate);
+        results->Add("fairnessIndex", fairnessIndex);
+        results->Add("appRxPackets", appRxPackets);
+        results->Add("appLostPackets", appLostPackets);
+        // Same columns in every run, NaN without the optional collectors
+        auto appDelayMs = [&delayProbe, &appDelay](double q) {
+            return delayProbe ? appDelay.GetQuantile(q).GetSeconds() * 1000 : std::nan("");
+        };
+        results->Add("appThroughputMbps",
+                     delayProbe ? delayProbe->GetReceivedBytes() * 8.0 / flowDuration / 1000 / 1000 : std::nan(""));
+        results->Add("appMeanDelayMs", delayProbe ? appDelay.GetMean().GetSeconds() * 1000 : std::nan(""));
+        results->Add("packetDelayP50Ms", appDelayMs(0.5));
+        results->Add("packetDelayP95Ms", appDelayMs(0.95));
+        results->Add("packetDelayP99Ms", appDelayMs(0.99));
+        results->Add("packetDelayP999Ms", appDelayMs(0.999));
+        results->Add("deadlineReliability",
+                     params.source == "urllc" ? UrllcHelper::GetReliability(serverApps) : std::nan(""));
+        results->Add("rlcDropRate", rlcQueues ? rlcQueues->GetDropRate() : std::nan(""));
+        results->Add("rlcSojournP99Ms",
+                     rlcQueues ? rlcQueues->GetSojourn().GetQuantile(0.99).GetSeconds() * 1000 : std::nan(""));
+        results->Add("macRbUtilization", macSlotStats ? macSlotStats->GetRbUtilization() : std::nan(""));
+        results->Add("macMeanMcs", macSlotStats ? macSlotStats->GetMeanMcs() : std::nan(""));
+        results->Add("meanSinrDb", linkQuality ? linkQuality->GetMeanSinrDb() : std::nan(""));
+        results->Add("runLengthS", runLength ? runLength->GetRunLength().GetSeconds() : std::nan(""));
+        results->Add("warmupS", runLength ? runLength->GetWarmupEnd().GetSeconds() : std::nan(""));
+        results->Add("steadyThroughputMbps", runLength ? runLength->GetSteadyThroughput() : std::nan(""));
+        results->Add("steadyDelayMs", runLength ? runLength->GetSteadyDelay() : std::nan(""));
+        bool beamStats = params.beamAngleThreshold > 0 || params.beamStats;
+        auto beams = IncrementalDirectPathBeamforming::GetTotalStatistics();
+        results->Add("beamformingCalls", beamStats ? beams.computed + beams.skipped : std::nan(""));
+        results->Add("beamformingS",
+                     beamStats ? std::chrono::duration<double>(beams.callTime).count() : std::nan(""));
+        double channelGenerations = 0.0;
+        double channelModelSeconds = 0.0;
+        for (const auto& cache : channelCaches)
+        {
+            channelGenerations += cache->GetGenerations();
+            channelModelSeconds += cache->GetModelSeconds();
+        }
+        results->Add("channelGenerations", channelCaches.empty() ? std::nan("") : channelGenerations);
+        results->Add("channelModelS", channelCaches.empty() ? std::nan("") : channelModelSeconds);
+        results->Add("setupWallTimeS", profile.GetSetupSeconds());
+        for (const auto& phase : profile.GetPhases())
+        {
+            std::string name = phase.first;
+            name[0] = std::toupper(name[0]);
+            results->Add("setup" + name + "S", phase.second);
+        }
+        results->Add("runWallTimeS", profile.GetRunSeconds());
+        results->Add("eventsProcessed", profile.GetEvents());
+        results->Add("eventsPerSecond", profile.GetEventsPerSecond());
+        results->Add("peakRssMiB", profile.GetPeakRssMiB());
+        results->Add("heapMiB", memoryUse.heapMiB);
+        results->Add("liveObjects", memoryUse.objects);
+        results->Add("flowMonitorKiB", memoryUse.flowMonitorBytes / 1024.0);
+        results->Add("peakHeapMiB", params.memoryInterval > 0 ? memory.GetPeaks().heapMiB : std::nan(""));
+        results->EndRecord();
+        if (params.results != "none")
+        {
+            for (const auto& path : results->Write(params.GetResultsPrefix()))
+            {
+                std::cout << "Results: " << path << "\n";
+            }
+        }
+        if (!params.runRecord.empty())
+        {
+            results->WriteLastRecord("run", params.runRecord);
+        }
+    }
+    if (params.eventProfile)
+    {
+        DynamicCast<ProfilingSimulatorImpl>(Simulator::GetImplementation())
+            ->Report(std::cout, profile.GetRunSeconds());
+    }
+
+    Simulator::Destroy();
+
+    std::cout << "Simulation end time: " << Simulator::Now().GetSeconds() << " seconds" << std::endl;
+
+    return EXIT_SUCCESS;
+}
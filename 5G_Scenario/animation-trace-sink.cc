@@ -0,0 +1,377 @@
+#include "animation-trace-sink.h"
+
+#include "ns3/abort.h"
+#include "ns3/config.h"
+#include "ns3/ipv4.h"
+#include "ns3/log.h"
+#include "ns3/mobility-model.h"
+#include "ns3/node-list.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("AnimationTraceSink");
+
+namespace
+{
+
+const char g_magic[8] = {'5', 'G', 'A', 'N', 'I', 'M', '1', '\n'};
+const std::size_t g_blockSize = 64 * 1024; // Bytes handed to the writer at once
+const std::size_t g_maxQueuedBlocks = 64;  // Back-pressure limit of the writer queue
+
+// Node id from a "/NodeList/<id>/..." trace context
+uint32_t
+ContextToNodeId(const std::string& context)
+{
+    return std::strtoul(context.c_str() + std::strlen("/NodeList/"), nullptr, 10);
+}
+
+} // namespace
+
+AnimationTraceSink::AnimationTraceSink(const std::string& path)
+{
+    m_file = std::fopen(path.c_str(), "wb");
+    NS_ABORT_MSG_IF(m_file == nullptr, "Cannot open animation trace " << path);
+    std::fwrite(g_magic, 1, sizeof(g_magic), m_file);
+    m_bytesWritten = sizeof(g_magic);
+    m_block.reserve(g_blockSize);
+    m_writer = std::thread(&AnimationTraceSink::WriterLoop, this);
+}
+
+AnimationTraceSink::~AnimationTraceSink()
+{
+    Finish();
+}
+
+void
+AnimationTraceSink::SetTimeWindow(Time start, Time stop)
+{
+    m_start = start;
+    m_stop = stop;
+}
+
+void
+AnimationTraceSink::SetPacketSampling(uint32_t n)
+{
+    m_sampling = std::max<uint32_t>(n, 1);
+}
+
+void
+AnimationTraceSink::SetMobilityPollInterval(Time interval)
+{
+    NS_ABORT_MSG_IF(!interval.IsStrictlyPositive(), "The mobility poll interval must be positive");
+    m_pollInterval = interval;
+}
+
+void
+AnimationTraceSink::UpdateNodeDescription(Ptr<Node> node, const std::string& description)
+{
+    BeginRecord(NODE_DESCRIPTION);
+    PutVarint(node->GetId());
+    PutVarint(description.size());
+    m_block.insert(m_block.end(), description.begin(), description.end());
+}
+
+void
+AnimationTraceSink::UpdateNodeColor(Ptr<Node> node, uint8_t r, uint8_t g, uint8_t b)
+{
+    BeginRecord(NODE_COLOR);
+    PutVarint(node->GetId());
+    m_block.push_back(r);
+    m_block.push_back(g);
+    m_block.push_back(b);
+}
+
+void
+AnimationTraceSink::Install()
+{
+    Config::Connect("/NodeList/*/$ns3::Ipv4L3Protocol/Tx",
+                    MakeCallback(&AnimationTraceSink::IpTx, this));
+    Config::Connect("/NodeList/*/$ns3::Ipv4L3Protocol/Rx",
+                    MakeCallback(&AnimationTraceSink::IpRx, this));
+    m_pollEvent = Simulator::Schedule(Max(m_start - Simulator::Now(), Seconds(0)),
+                                      &AnimationTraceSink::PollPositions,
+                                      this);
+}
+
+void
+AnimationTraceSink::Finish()
+{
+    if (!m_writer.joinable())
+    {
+        return;
+    }
+    SubmitBlock();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_done = true;
+    }
+    m_ready.notify_one();
+    m_writer.join();
+    std::fclose(m_file);
+    m_file = nullptr;
+    NS_LOG_INFO("Animation trace: " << m_records << " records, " << m_bytesWritten << " bytes");
+}
+
+uint64_t
+AnimationTraceSink::GetRecords() const
+{
+    return m_records;
+}
+
+uint64_t
+AnimationTraceSink::GetBytesWritten() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bytesWritten;
+}
+
+uint64_t
+AnimationTraceSink::GetBufferedBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queuedBytes + m_block.capacity();
+}
+
+bool
+AnimationTraceSink::InWindow() const
+{
+    Time now = Simulator::Now();
+    return now >= m_start && now <= m_stop;
+}
+
+void
+AnimationTraceSink::PollPositions()
+{
+    for (auto it = NodeList::Begin(); it != NodeList::End(); ++it)
+    {
+        Ptr<MobilityModel> mobility = (*it)->GetObject<MobilityModel>();
+        if (!mobility)
+        {
+            continue;
+        }
+        Vector position = mobility->GetPosition();
+        std::vector<int64_t> cm = {std::llround(position.x * 100),
+                                   std::llround(position.y * 100),
+                                   std::llround(position.z * 100)};
+        auto& last = m_lastPosition[(*it)->GetId()];
+        if (last == cm)
+        {
+            continue; // Only moving nodes produce records after the first poll
+        }
+        if (last.empty())
+        {
+            last.assign(3, 0);
+        }
+        BeginRecord(POSITION);
+        PutVarint((*it)->GetId());
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            PutSigned(cm[i] - last[i]);
+        }
+        last = cm;
+    }
+
+    if (Simulator::Now() + m_pollInterval <= m_stop)
+    {
+        m_pollEvent = Simulator::Schedule(m_pollInterval, &AnimationTraceSink::PollPositions, this);
+    }
+}
+
+void
+AnimationTraceSink::IpTx(std::string context, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+    PacketEvent(PACKET_TX, context, packet);
+}
+
+void
+AnimationTraceSink::IpRx(std::string context, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+    PacketEvent(PACKET_RX, context, packet);
+}
+
+void
+AnimationTraceSink::PacketEvent(RecordType type, const std::string& context, Ptr<const Packet> packet)
+{
+    if (packet->GetUid() % m_sampling != 0 || !InWindow())
+    {
+        return;
+    }
+    BeginRecord(type);
+    PutVarint(ContextToNodeId(context));
+    PutVarint(packet->GetUid());
+    PutVarint(packet->GetSize());
+}
+
+void
+AnimationTraceSink::BeginRecord(RecordType type)
+{
+    if (m_block.size() >= g_blockSize)
+    {
+        SubmitBlock();
+    }
+    int64_t now = Simulator::Now().GetNanoSeconds();
+    m_block.push_back(type);
+    PutVarint(now - m_lastTime);
+    m_lastTime = now;
+    ++m_records;
+}
+
+void
+AnimationTraceSink::PutVarint(uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        m_block.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    m_block.push_back(static_cast<uint8_t>(value));
+}
+
+void
+AnimationTraceSink::PutSigned(int64_t value)
+{
+    PutVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void
+AnimationTraceSink::SubmitBlock()
+{
+    if (m_block.empty())
+    {
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_space.wait(lock, [this] { return m_queue.size() < g_maxQueuedBlocks; });
+        m_queuedBytes += m_block.size();
+        m_queue.push_back(std::move(m_block));
+    }
+    m_ready.notify_one();
+    m_block = std::vector<uint8_t>();
+    m_block.reserve(g_blockSize);
+}
+
+void
+AnimationTraceSink::WriterLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_ready.wait(lock, [this] { return !m_queue.empty() || m_done; });
+        if (m_queue.empty())
+        {
+            break;
+        }
+        std::vector<uint8_t> block = std::move(m_queue.front());
+        m_queue.pop_front();
+        lock.unlock();
+        m_space.notify_one();
+
+        std::fwrite(block.data(), 1, block.size(), m_file);
+
+        lock.lock();
+        m_queuedBytes -= block.size();
+        m_bytesWritten += block.size();
+    }
+    std::fflush(m_file);
+}
+
+void
+AnimationTraceSink::Decode(const std::string& path, std::ostream& os)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    NS_ABORT_MSG_IF(data.size() < sizeof(g_magic) || std::memcmp(data.data(), g_magic, sizeof(g_magic)) != 0,
+                    path << " is not an animation trace");
+
+    std::size_t pos = sizeof(g_magic);
+    auto need = [&data, &pos, &path](std::size_t bytes) {
+        NS_ABORT_MSG_IF(bytes > data.size() - pos, "Truncated animation trace " << path);
+    };
+    auto getVarint = [&data, &pos, &need]() {
+        uint64_t value = 0;
+        for (int shift = 0;; shift += 7)
+        {
+            need(1);
+            uint8_t byte = data[pos++];
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+            {
+                break;
+            }
+        }
+        return value;
+    };
+    auto getSigned = [&getVarint]() {
+        uint64_t value = getVarint();
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    };
+
+    // Nanosecond times and centimetre positions, written in full
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << std::fixed;
+
+    std::map<uint32_t, std::vector<int64_t>> positions;
+    int64_t time = 0;
+    os << "time,record,node,fields\n";
+    while (pos < data.size())
+    {
+        uint8_t type = data[pos++];
+        time += getVarint();
+        uint32_t node = getVarint();
+        os << std::setprecision(9) << time * 1e-9 << "," << std::setprecision(2);
+        switch (type)
+        {
+        case NODE_DESCRIPTION: {
+            std::size_t len = getVarint();
+            need(len);
+            os << "description," << node << ","
+               << std::string(data.begin() + pos, data.begin() + pos + len);
+            pos += len;
+            break;
+        }
+        case NODE_COLOR:
+            need(3);
+            os << "color," << node << "," << +data[pos] << "," << +data[pos + 1] << ","
+               << +data[pos + 2];
+            pos += 3;
+            break;
+        case POSITION: {
+            auto& p = positions[node];
+            p.resize(3, 0);
+            for (auto& coordinate : p)
+            {
+                coordinate += getSigned();
+            }
+            os << "position," << node << "," << p[0] / 100.0 << "," << p[1] / 100.0 << ","
+               << p[2] / 100.0;
+            break;
+        }
+        case PACKET_TX:
+        case PACKET_RX: {
+            uint64_t uid = getVarint();
+            uint64_t size = getVarint();
+            os << (type == PACKET_TX ? "tx," : "rx,") << node << "," << uid << "," << size;
+            break;
+        }
+        default:
+            NS_ABORT_MSG("Corrupted animation trace " << path);
+        }
+        os << "\n";
+    }
+    os.flags(flags);
+    os.precision(precision);
+}
+
+} // namespace ns3
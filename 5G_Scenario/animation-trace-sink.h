@@ -0,0 +1,123 @@
+#ifndef ANIMATION_TRACE_SINK_H
+#define ANIMATION_TRACE_SINK_H
+
+#include "ns3/event-id.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+#include "ns3/vector.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+class Ipv4;
+
+/**
+ * Compact replacement of the NetAnim XML trace for large runs.
+ *
+ * Records node descriptions, node positions and IP level packet tx/rx in a
+ * binary stream where every timestamp is a delta from the previous record and
+ * every integer is a varint (positions are zigzag deltas in centimetres from
+ * the last written position of the node). Only [start, stop] is recorded,
+ * packets are sampled 1-in-N on their uid (so a sampled packet keeps both its
+ * tx and rx records) and positions are polled at a configurable interval.
+ *
+ * The simulation thread only appends to an in-memory block; full blocks are
+ * written by a background thread, with a bounded queue so that a slow disk
+ * throttles the simulation instead of growing memory. Decode() turns a file
+ * back into CSV.
+ */
+class AnimationTraceSink
+{
+  public:
+    /// Open the output file and start the writer thread
+    explicit AnimationTraceSink(const std::string& path);
+    /// Flush the pending records and join the writer thread
+    ~AnimationTraceSink();
+
+    AnimationTraceSink(const AnimationTraceSink&) = delete;
+    AnimationTraceSink& operator=(const AnimationTraceSink&) = delete;
+
+    /// Only record events with start <= t <= stop
+    void SetTimeWindow(Time start, Time stop);
+    /// Record one packet out of n (1 records all of them)
+    void SetPacketSampling(uint32_t n);
+    /// Interval between two polls of the node positions
+    void SetMobilityPollInterval(Time interval);
+
+    void UpdateNodeDescription(Ptr<Node> node, const std::string& description);
+    void UpdateNodeColor(Ptr<Node> node, uint8_t r, uint8_t g, uint8_t b);
+
+    /// Connect the IP traces of all nodes and schedule the position polls
+    void Install();
+    /// Flush the pending records and stop the writer thread
+    void Finish();
+
+    uint64_t GetRecords() const;
+    uint64_t GetBytesWritten() const;
+    /// Bytes buffered in memory and not yet written to disk
+    uint64_t GetBufferedBytes() const;
+
+    /// Convert a binary trace into CSV lines "time,record,node,fields..."
+    static void Decode(const std::string& path, std::ostream& os);
+
+  private:
+    enum RecordType : uint8_t
+    {
+        NODE_DESCRIPTION = 1,
+        NODE_COLOR = 2,
+        POSITION = 3,
+        PACKET_TX = 4,
+        PACKET_RX = 5
+    };
+
+    bool InWindow() const;
+    void PollPositions();
+    void IpTx(std::string context, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+    void IpRx(std::string context, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+    void PacketEvent(RecordType type, const std::string& context, Ptr<const Packet> packet);
+
+    void BeginRecord(RecordType type);
+    void PutVarint(uint64_t value);
+    void PutSigned(int64_t value);
+    void SubmitBlock();
+    void WriterLoop();
+
+    std::FILE* m_file{nullptr};
+    Time m_start{Seconds(0)};
+    Time m_stop{Time::Max()};
+    uint32_t m_sampling{1};
+    Time m_pollInterval{MilliSeconds(250)};
+    EventId m_pollEvent;
+
+    std::map<uint32_t, std::vector<int64_t>> m_lastPosition; // Last written position in cm
+    int64_t m_lastTime{0};                                    // Time of the last record in ns
+    std::vector<uint8_t> m_block;
+    uint64_t m_records{0};
+
+    // Shared with the writer thread
+    mutable std::mutex m_mutex;
+    std::condition_variable m_ready;
+    std::condition_variable m_space;
+    std::deque<std::vector<uint8_t>> m_queue;
+    uint64_t m_queuedBytes{0};
+    uint64_t m_bytesWritten{0};
+    bool m_done{false};
+    std::thread m_writer;
+};
+
+} // namespace ns3
+
+#endif // ANIMATION_TRACE_SINK_H
@@ -0,0 +1,322 @@
+#include "cached-channel-model.h"
+
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/object-factory.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(CachedChannelModel);
+
+namespace
+{
+
+// Streams of the reference models of the accuracy check, far above the ones
+// the scenario assigns so that the check does not change the run
+const int64_t g_referenceStream = 1000000;
+
+} // namespace
+
+TypeId
+CachedChannelModel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::CachedChannelModel")
+            .SetParent<MatrixBasedChannelModel>()
+            .SetGroupName("Spectrum")
+            .AddConstructor<CachedChannelModel>()
+            .AddAttribute("Frequency",
+                          "Frequency of the wrapped channel model in Hz",
+                          TypeId::ATTR_GET,
+                          DoubleValue(0.0),
+                          MakeDoubleAccessor(&CachedChannelModel::GetFrequency),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("Enabled",
+                          "Reuse matrices; if false every call goes to the wrapped model and is only counted",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&CachedChannelModel::m_enabled),
+                          MakeBooleanChecker())
+            .AddAttribute("Distance",
+                          "Reuse a matrix until one end has moved more than this many meters",
+                          DoubleValue(1.0),
+                          MakeDoubleAccessor(&CachedChannelModel::m_distance),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("CoherenceTime",
+                          "Reuse a matrix for at most this long (0 means no limit)",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&CachedChannelModel::m_coherenceTime),
+                          MakeTimeChecker())
+            .AddAttribute("CheckAccuracy",
+                          "Compare reused matrices with the uncached path",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&CachedChannelModel::m_checkAccuracy),
+                          MakeBooleanChecker())
+            .AddAttribute("CheckInterval",
+                          "Compare one hit out of this many with the uncached path",
+                          UintegerValue(100),
+                          MakeUintegerAccessor(&CachedChannelModel::m_checkInterval),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+CachedChannelModel::CachedChannelModel()
+{
+}
+
+void
+CachedChannelModel::SetChannelModel(Ptr<MatrixBasedChannelModel> model)
+{
+    m_model = model;
+}
+
+Ptr<MatrixBasedChannelModel>
+CachedChannelModel::GetChannelModel() const
+{
+    return m_model;
+}
+
+double
+CachedChannelModel::GetFrequency() const
+{
+    if (!m_model)
+    {
+        return 0.0;
+    }
+    DoubleValue frequency;
+    m_model->GetAttribute("Frequency", frequency);
+    return frequency.Get();
+}
+
+bool
+CachedChannelModel::IsFresh(const Entry& entry, const Vector& aPosition, const Vector& bPosition) const
+{
+    if (m_coherenceTime.IsStrictlyPositive() && Simulator::Now() - entry.generated > m_coherenceTime)
+    {
+        return false;
+    }
+    return CalculateDistance(entry.aPosition, aPosition) <= m_distance &&
+           CalculateDistance(entry.bPosition, bPosition) <= m_distance;
+}
+
+double
+CachedChannelModel::GainDb(const ChannelMatrix& matrix,
+                           Ptr<const PhasedArrayModel> aAntenna,
+                           Ptr<const PhasedArrayModel> bAntenna)
+{
+    // Rows are the elements of the receiving array, whichever of the two it is
+    const auto& h = matrix.m_channel;
+    bool aReceives = h.GetNumRows() == aAntenna->GetNumElems() && h.GetNumCols() == bAntenna->GetNumElems();
+    Ptr<const PhasedArrayModel> u = aReceives ? aAntenna : bAntenna;
+    Ptr<const PhasedArrayModel> s = aReceives ? bAntenna : aAntenna;
+    PhasedArrayModel::ComplexVector uW = u->GetBeamformingVector();
+    PhasedArrayModel::ComplexVector sW = s->GetBeamformingVector();
+    if (uW.GetSize() != h.GetNumRows() || sW.GetSize() != h.GetNumCols())
+    {
+        return std::nan("");
+    }
+
+    // Long term (beamformed) gain summed over the clusters, as the spectrum
+    // propagation loss model computes it
+    double gain = 0.0;
+    for (std::size_t c = 0; c < h.GetNumPages(); ++c)
+    {
+        std::complex<double> rxSum = 0;
+        for (std::size_t i = 0; i < h.GetNumRows(); ++i)
+        {
+            std::complex<double> txSum = 0;
+            for (std::size_t j = 0; j < h.GetNumCols(); ++j)
+            {
+                txSum += sW[j] * h(i, j, c);
+            }
+            rxSum += std::conj(uW[i]) * txSum;
+        }
+        gain += std::norm(rxSum);
+    }
+    return 10 * std::log10(std::max(gain, 1e-30));
+}
+
+void
+CachedChannelModel::CheckAccuracy(const Entry& entry,
+                                  Ptr<const MobilityModel> aMob,
+                                  Ptr<const MobilityModel> bMob,
+                                  Ptr<const PhasedArrayModel> aAntenna,
+                                  Ptr<const PhasedArrayModel> bAntenna)
+{
+    // Two instances of the wrapped model, with the same propagation conditions
+    // (they share its channel condition model, so LOS/NLOS agrees) but their
+    // own random streams, stand for the uncached path without touching the
+    // matrices of the wrapped one
+    if (m_references.empty())
+    {
+        DoubleValue frequency;
+        StringValue scenario;
+        PointerValue condition;
+        m_model->GetAttribute("Frequency", frequency);
+        m_model->GetAttribute("Scenario", scenario);
+        m_model->GetAttribute("ChannelConditionModel", condition);
+        ObjectFactory factory(m_model->GetInstanceTypeId().GetName());
+        factory.Set("Frequency", frequency);
+        factory.Set("Scenario", scenario);
+        factory.Set("ChannelConditionModel", condition);
+        // Regenerate on every check, which always happens at a later time
+        factory.Set("UpdatePeriod", TimeValue(NanoSeconds(1)));
+        for (int64_t i = 0; i < 2; ++i)
+        {
+            Ptr<MatrixBasedChannelModel> reference = factory.Create<MatrixBasedChannelModel>();
+            reference->AssignStreams(g_referenceStream + i * 1000);
+            m_references.push_back(reference);
+        }
+    }
+    double cached = GainDb(*entry.matrix, aAntenna, bAntenna);
+    double fresh = GainDb(*m_references[0]->GetChannel(aMob, bMob, aAntenna, bAntenna), aAntenna, bAntenna);
+    double other = GainDb(*m_references[1]->GetChannel(aMob, bMob, aAntenna, bAntenna), aAntenna, bAntenna);
+    if (std::isnan(cached) || std::isnan(fresh) || std::isnan(other))
+    {
+        return;
+    }
+    ++m_checks;
+    m_gainErrorSum += std::abs(cached - fresh);
+    m_gainErrorMax = std::max(m_gainErrorMax, std::abs(cached - fresh));
+    m_spreadSum += std::abs(other - fresh);
+}
+
+Ptr<const MatrixBasedChannelModel::ChannelMatrix>
+CachedChannelModel::GetChannel(Ptr<const MobilityModel> aMob,
+                               Ptr<const MobilityModel> bMob,
+                               Ptr<const PhasedArrayModel> aAntenna,
+                               Ptr<const PhasedArrayModel> bAntenna)
+{
+    // The wrapped model returns the same matrix for both directions
+    const MobilityModel* first = std::min(PeekPointer(aMob), PeekPointer(bMob));
+    const MobilityModel* second = std::max(PeekPointer(aMob), PeekPointer(bMob));
+    Vector aPosition = aMob->GetPosition();
+    Vector bPosition = bMob->GetPosition();
+
+    auto it = m_entries.find({first, second});
+    if (m_enabled && it != m_entries.end())
+    {
+        Entry& entry = it->second;
+        bool sameOrder = entry.aAntenna == aAntenna && entry.bAntenna == bAntenna;
+        bool reversed = entry.aAntenna == bAntenna && entry.bAntenna == aAntenna;
+        if ((sameOrder && IsFresh(entry, aPosition, bPosition)) ||
+            (reversed && IsFresh(entry, bPosition, aPosition)))
+        {
+            ++m_hits;
+            if (m_checkAccuracy && m_hits % m_checkInterval == 0)
+            {
+                CheckAccuracy(entry, aMob, bMob, aAntenna, bAntenna);
+            }
+            return entry.matrix;
+        }
+    }
+
+    ++m_misses;
+    auto start = std::chrono::steady_clock::now();
+    Ptr<const ChannelMatrix> matrix = m_model->GetChannel(aMob, bMob, aAntenna, bAntenna);
+    m_modelTime += std::chrono::steady_clock::now() - start;
+
+    // The wrapped model hands back the matrix it already had unless it regenerated it
+    if (it == m_entries.end() || it->second.matrix != matrix)
+    {
+        ++m_generations;
+    }
+    Entry& entry = m_entries[{first, second}];
+    if (entry.matrix != matrix || entry.aAntenna != aAntenna || entry.bAntenna != bAntenna)
+    {
+        entry.matrix = matrix;
+        entry.aAntenna = aAntenna;
+        entry.bAntenna = bAntenna;
+        entry.aPosition = aPosition;
+        entry.bPosition = bPosition;
+        entry.generated = Simulator::Now();
+    }
+    return matrix;
+}
+
+Ptr<const MatrixBasedChannelModel::ChannelParams>
+CachedChannelModel::GetParams(Ptr<const MobilityModel> aMob, Ptr<const MobilityModel> bMob) const
+{
+    return m_model->GetParams(aMob, bMob);
+}
+
+int64_t
+CachedChannelModel::AssignStreams(int64_t stream)
+{
+    return m_model->AssignStreams(stream);
+}
+
+uint64_t
+CachedChannelModel::GetHits() const
+{
+    return m_hits;
+}
+
+uint64_t
+CachedChannelModel::GetMisses() const
+{
+    return m_misses;
+}
+
+uint64_t
+CachedChannelModel::GetGenerations() const
+{
+    return m_generations;
+}
+
+double
+CachedChannelModel::GetModelSeconds() const
+{
+    return std::chrono::duration<double>(m_modelTime).count();
+}
+
+uint64_t
+CachedChannelModel::GetChecks() const
+{
+    return m_checks;
+}
+
+double
+CachedChannelModel::GetMeanGainError() const
+{
+    return m_checks > 0 ? m_gainErrorSum / m_checks : 0.0;
+}
+
+double
+CachedChannelModel::GetMaxGainError() const
+{
+    return m_gainErrorMax;
+}
+
+double
+CachedChannelModel::GetMeanRealizationSpread() const
+{
+    return m_checks > 0 ? m_spreadSum / m_checks : 0.0;
+}
+
+uint64_t
+CachedChannelModel::GetEntries() const
+{
+    return m_entries.size();
+}
+
+uint64_t
+CachedChannelModel::GetMatrixBytes() const
+{
+    uint64_t bytes = 0;
+    for (const auto& entry : m_entries)
+    {
+        bytes += entry.second.matrix->m_channel.GetSize() * sizeof(std::complex<double>);
+    }
+    return bytes;
+}
+
+} // namespace ns3
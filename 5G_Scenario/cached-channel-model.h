@@ -0,0 +1,126 @@
+#ifndef CACHED_CHANNEL_MODEL_H
+#define CACHED_CHANNEL_MODEL_H
+
+#include "ns3/matrix-based-channel-model.h"
+#include "ns3/mobility-model.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * MatrixBasedChannelModel that reuses the channel matrix of a gNB/UE pair
+ * until one of them has moved more than a given distance or the matrix is
+ * older than a coherence time.
+ *
+ * It wraps the ThreeGppChannelModel of one bandwidth part, so the cache is
+ * keyed on (gNB, UE, BWP). The wrapped model keeps its own UpdatePeriod: a
+ * cache miss is passed to it and regenerates the matrix only if the model
+ * would have done so without the cache, so the cache can only skip
+ * regenerations of a configuration that has a non-zero update period. Hits
+ * return the same matrix and keep the long term beamforming cache of
+ * ThreeGppSpectrumPropagationLossModel valid.
+ *
+ * Whether enabled or not, the wrapper counts the matrices the wrapped model
+ * generates and the wall time spent in it, so the same run with the cache
+ * disabled is the baseline the saving is measured against.
+ *
+ * With the accuracy check enabled, one hit out of CheckInterval is compared
+ * with the matrix the uncached path would return: a separate instance of the
+ * wrapped model (same frequency, scenario and channel condition model, its
+ * own random streams) generates a matrix for the current positions, and the
+ * error is the difference of their beamformed gains with the current beams
+ * of both antennas. A second fresh matrix gives the gain difference between
+ * two realizations of the uncached path, the floor of that error.
+ */
+class CachedChannelModel : public MatrixBasedChannelModel
+{
+  public:
+    static TypeId GetTypeId();
+
+    CachedChannelModel();
+
+    /// Model that generates the matrices on a cache miss
+    void SetChannelModel(Ptr<MatrixBasedChannelModel> model);
+    Ptr<MatrixBasedChannelModel> GetChannelModel() const;
+
+    Ptr<const ChannelMatrix> GetChannel(Ptr<const MobilityModel> aMob,
+                                        Ptr<const MobilityModel> bMob,
+                                        Ptr<const PhasedArrayModel> aAntenna,
+                                        Ptr<const PhasedArrayModel> bAntenna) override;
+    Ptr<const ChannelParams> GetParams(Ptr<const MobilityModel> aMob,
+                                       Ptr<const MobilityModel> bMob) const override;
+    int64_t AssignStreams(int64_t stream) override;
+
+    uint64_t GetHits() const;
+    uint64_t GetMisses() const;
+    /// Matrices generated by the wrapped model and the wall time of the calls to it, in seconds
+    uint64_t GetGenerations() const;
+    double GetModelSeconds() const;
+
+    /// Hits compared with the uncached path
+    uint64_t GetChecks() const;
+    /// Mean and maximum beamformed gain error of a reused matrix against a fresh one, in dB
+    double GetMeanGainError() const;
+    double GetMaxGainError() const;
+    /// Mean beamformed gain difference between two fresh matrices, in dB
+    double GetMeanRealizationSpread() const;
+
+    /// Channel matrices held by the cache and the bytes of their coefficients
+    uint64_t GetEntries() const;
+    uint64_t GetMatrixBytes() const;
+
+  private:
+    struct Entry
+    {
+        Ptr<const ChannelMatrix> matrix;
+        Ptr<const PhasedArrayModel> aAntenna;
+        Ptr<const PhasedArrayModel> bAntenna;
+        Vector aPosition;
+        Vector bPosition;
+        Time generated;
+    };
+
+    bool IsFresh(const Entry& entry, const Vector& aPosition, const Vector& bPosition) const;
+    /// Compare a reused matrix with the uncached path for the same pair and antennas
+    void CheckAccuracy(const Entry& entry,
+                       Ptr<const MobilityModel> aMob,
+                       Ptr<const MobilityModel> bMob,
+                       Ptr<const PhasedArrayModel> aAntenna,
+                       Ptr<const PhasedArrayModel> bAntenna);
+    /// Beamformed gain of a matrix with the current beams of the antennas, in dB (NaN without beams)
+    static double GainDb(const ChannelMatrix& matrix,
+                         Ptr<const PhasedArrayModel> aAntenna,
+                         Ptr<const PhasedArrayModel> bAntenna);
+
+    double GetFrequency() const;
+
+    Ptr<MatrixBasedChannelModel> m_model;
+    std::vector<Ptr<MatrixBasedChannelModel>> m_references; // Uncached path of the accuracy check
+    bool m_enabled;
+    double m_distance;
+    Time m_coherenceTime;
+    bool m_checkAccuracy;
+    uint32_t m_checkInterval;
+    std::map<std::pair<const MobilityModel*, const MobilityModel*>, Entry> m_entries;
+
+    uint64_t m_hits{0};
+    uint64_t m_misses{0};
+    uint64_t m_generations{0};
+    std::chrono::steady_clock::duration m_modelTime{0};
+    uint64_t m_checks{0};
+    double m_gainErrorSum{0.0};
+    double m_gainErrorMax{0.0};
+    double m_spreadSum{0.0};
+};
+
+} // namespace ns3
+
+#endif // CACHED_CHANNEL_MODEL_H
@@ -0,0 +1,205 @@
+#include "columnar-writer.h"
+
+#include "ns3/abort.h"
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+namespace ns3
+{
+
+namespace
+{
+
+const char g_magic[8] = {'5', 'G', 'C', 'O', 'L', '1', '\n', '\0'};
+
+std::size_t
+TypeSize(uint8_t type)
+{
+    return type == ColumnarWriter::UINT32 ? 4 : 8;
+}
+
+} // namespace
+
+ColumnarWriter::ColumnarWriter(const std::string& path, const Columns& columns, uint32_t rowsPerBlock)
+    : m_path(path),
+      m_columns(columns),
+      m_data(columns.size()),
+      m_rowsPerBlock(rowsPerBlock)
+{
+    m_file = std::fopen(path.c_str(), "wb");
+    NS_ABORT_MSG_IF(m_file == nullptr, "Cannot open " << path);
+
+    std::fwrite(g_magic, 1, sizeof(g_magic), m_file);
+    uint32_t count = columns.size();
+    std::fwrite(&count, sizeof(count), 1, m_file);
+    for (const auto& column : columns)
+    {
+        uint16_t length = column.first.size();
+        std::fwrite(&column.second, 1, 1, m_file);
+        std::fwrite(&length, sizeof(length), 1, m_file);
+        std::fwrite(column.first.data(), 1, length, m_file);
+    }
+    for (std::size_t i = 0; i < columns.size(); ++i)
+    {
+        m_data[i].reserve(static_cast<std::size_t>(rowsPerBlock) * TypeSize(columns[i].second));
+    }
+}
+
+ColumnarWriter::~ColumnarWriter()
+{
+    Close();
+}
+
+void
+ColumnarWriter::Append(const void* value, std::size_t size, ColumnType type)
+{
+    NS_ABORT_MSG_IF(m_nextColumn >= m_columns.size() || m_columns[m_nextColumn].second != type,
+                    "Value does not match column " << m_nextColumn << " of " << m_path);
+    auto bytes = static_cast<const uint8_t*>(value);
+    m_data[m_nextColumn].insert(m_data[m_nextColumn].end(), bytes, bytes + size);
+    ++m_nextColumn;
+}
+
+void
+ColumnarWriter::AppendUint32(uint32_t value)
+{
+    Append(&value, sizeof(value), UINT32);
+}
+
+void
+ColumnarWriter::AppendUint64(uint64_t value)
+{
+    Append(&value, sizeof(value), UINT64);
+}
+
+void
+ColumnarWriter::AppendDouble(double value)
+{
+    Append(&value, sizeof(value), DOUBLE);
+}
+
+void
+ColumnarWriter::EndRow()
+{
+    NS_ABORT_MSG_IF(m_nextColumn != m_columns.size(), "Incomplete row in " << m_path);
+    m_nextColumn = 0;
+    ++m_rows;
+    if (++m_blockRows == m_rowsPerBlock)
+    {
+        FlushBlock();
+    }
+}
+
+void
+ColumnarWriter::FlushBlock()
+{
+    if (m_blockRows == 0)
+    {
+        return;
+    }
+    std::fwrite(&m_blockRows, sizeof(m_blockRows), 1, m_file);
+    for (auto& column : m_data)
+    {
+        std::fwrite(column.data(), 1, column.size(), m_file);
+        column.clear();
+    }
+    m_blockRows = 0;
+}
+
+void
+ColumnarWriter::Close()
+{
+    if (m_file == nullptr)
+    {
+        return;
+    }
+    FlushBlock();
+    std::fclose(m_file);
+    m_file = nullptr;
+}
+
+uint64_t
+ColumnarWriter::GetRows() const
+{
+    return m_rows;
+}
+
+const std::string&
+ColumnarWriter::GetPath() const
+{
+    return m_path;
+}
+
+void
+ColumnarWriter::ExportCsv(const std::string& path, std::ostream& os)
+{
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(g_magic)];
+    in.read(magic, sizeof(magic));
+    NS_ABORT_MSG_IF(!in || std::memcmp(magic, g_magic, sizeof(g_magic)) != 0,
+                    path << " is not a columnar file");
+
+    uint32_t count = 0;
+    in.read(reinterpret_cast<char*>(&count), sizeof(count));
+    std::vector<uint8_t> types(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint16_t length = 0;
+        in.read(reinterpret_cast<char*>(&types[i]), 1);
+        in.read(reinterpret_cast<char*>(&length), sizeof(length));
+        std::string name(length, '\0');
+        in.read(&name[0], length);
+        os << (i > 0 ? "," : "") << name;
+    }
+    os << "\n";
+
+    // Doubles round trip, so that close timestamps stay apart
+    std::ios state(nullptr);
+    state.copyfmt(os);
+    os << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+    uint32_t rows = 0;
+    std::vector<std::vector<uint8_t>> block(count);
+    while (in.read(reinterpret_cast<char*>(&rows), sizeof(rows)))
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            block[i].resize(static_cast<std::size_t>(rows) * TypeSize(types[i]));
+            in.read(reinterpret_cast<char*>(block[i].data()), block[i].size());
+        }
+        NS_ABORT_MSG_IF(!in, "Truncated block in " << path);
+        for (uint32_t r = 0; r < rows; ++r)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                const uint8_t* cell = block[i].data() + r * TypeSize(types[i]);
+                os << (i > 0 ? "," : "");
+                if (types[i] == UINT32)
+                {
+                    uint32_t value;
+                    std::memcpy(&value, cell, sizeof(value));
+                    os << value;
+                }
+                else if (types[i] == UINT64)
+                {
+                    uint64_t value;
+                    std::memcpy(&value, cell, sizeof(value));
+                    os << value;
+                }
+                else
+                {
+                    double value;
+                    std::memcpy(&value, cell, sizeof(value));
+                    os << value;
+                }
+            }
+            os << "\n";
+        }
+    }
+    os.copyfmt(state);
+}
+
+} // namespace ns3
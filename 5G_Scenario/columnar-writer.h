@@ -0,0 +1,72 @@
+#ifndef COLUMNAR_WRITER_H
+#define COLUMNAR_WRITER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Column-oriented binary file for time series.
+ *
+ * The file starts with the column names and types, followed by blocks of up
+ * to `rowsPerBlock` rows. Each block stores its row count and then every
+ * column as one contiguous little-endian array, so a reader can pick a single
+ * column of a block by skipping the others without parsing them. Rows are
+ * built with the Append* methods in column order, then EndRow().
+ */
+class ColumnarWriter
+{
+  public:
+    enum ColumnType : uint8_t
+    {
+        UINT32 = 1,
+        UINT64 = 2,
+        DOUBLE = 3
+    };
+
+    using Columns = std::vector<std::pair<std::string, ColumnType>>;
+
+    ColumnarWriter(const std::string& path, const Columns& columns, uint32_t rowsPerBlock = 65536);
+    /// Write the last partial block and close the file
+    ~ColumnarWriter();
+
+    ColumnarWriter(const ColumnarWriter&) = delete;
+    ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+
+    void AppendUint32(uint32_t value);
+    void AppendUint64(uint64_t value);
+    void AppendDouble(double value);
+    void EndRow();
+
+    /// Flush the pending rows and close the file
+    void Close();
+
+    uint64_t GetRows() const;
+    const std::string& GetPath() const;
+
+    /// Print a columnar file as CSV, with the column names as header
+    static void ExportCsv(const std::string& path, std::ostream& os);
+
+  private:
+    void Append(const void* value, std::size_t size, ColumnType type);
+    void FlushBlock();
+
+    std::string m_path;
+    std::FILE* m_file{nullptr};
+    Columns m_columns;
+    std::vector<std::vector<uint8_t>> m_data; // One buffer per column
+    std::size_t m_nextColumn{0};
+    uint32_t m_rowsPerBlock;
+    uint32_t m_blockRows{0};
+    uint64_t m_rows{0};
+};
+
+} // namespace ns3
+
+#endif // COLUMNAR_WRITER_H
@@ -0,0 +1,238 @@
+#include "delay-aware-schedulers.h"
+
+#include "ns3/double.h"
+#include "ns3/nr-mac-scheduler-ue-info-pf.h"
+
+#include <cmath>
+#include <limits>
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(NrMacSchedulerTdmaEdf);
+NS_OBJECT_ENSURE_REGISTERED(NrMacSchedulerTdmaMlwdf);
+NS_OBJECT_ENSURE_REGISTERED(NrMacSchedulerOfdmaEdf);
+NS_OBJECT_ENSURE_REGISTERED(NrMacSchedulerOfdmaMlwdf);
+
+namespace
+{
+
+// Budget used for LCs whose QCI does not define one, in ms
+const double g_defaultBudget = 100.0;
+
+// The PF schedulers create NrMacSchedulerUeInfoPF for every UE
+const NrMacSchedulerUeInfoPF&
+AsPf(const NrMacSchedulerNs3::UePtrAndBufferReq& ue)
+{
+    return *static_cast<const NrMacSchedulerUeInfoPF*>(ue.first.get());
+}
+
+bool
+ComparePf(const NrMacSchedulerNs3::UePtrAndBufferReq& lhs, const NrMacSchedulerNs3::UePtrAndBufferReq& rhs)
+{
+    return NrMacSchedulerUeInfoPF::CompareUeWeightsDl(lhs, rhs);
+}
+
+} // namespace
+
+void
+DelayAwareOrdering::GetMostUrgent(const NrMacSchedulerUeInfo& ue, double* holDelay, double* budget)
+{
+    double bestSlack = std::numeric_limits<double>::infinity();
+    *holDelay = 0.0;
+    *budget = g_defaultBudget;
+    for (const auto& lcg : ue.m_dlLCG)
+    {
+        for (uint8_t lcId : lcg.second->GetActiveLCIds())
+        {
+            const auto& lc = lcg.second->GetLC(lcId);
+            double lcBudget = lc->m_delayBudget.IsStrictlyPositive() ? lc->m_delayBudget.GetMilliSeconds()
+                                                                      : g_defaultBudget;
+            double lcHolDelay = std::max(lc->m_rlcTransmissionQueueHolDelay, lc->m_rlcRetransmissionHolDelay);
+            if (lcBudget - lcHolDelay < bestSlack)
+            {
+                bestSlack = lcBudget - lcHolDelay;
+                *holDelay = lcHolDelay;
+                *budget = lcBudget;
+            }
+        }
+    }
+}
+
+void
+DelayAwareOrdering::UpdateEdf(const UePtrAndBufferReq& ue)
+{
+    double hol;
+    double budget;
+    GetMostUrgent(*ue.first, &hol, &budget);
+    m_keys[ue.first.get()] = budget - hol;
+}
+
+void
+DelayAwareOrdering::UpdateMlwdf(const UePtrAndBufferReq& ue, double violationProbability)
+{
+    double hol;
+    double budget;
+    GetMostUrgent(*ue.first, &hol, &budget);
+    const NrMacSchedulerUeInfoPF& pf = AsPf(ue);
+    // Packets just queued still compete on the PF metric alone
+    double delay = std::max(hol, 1.0);
+    double weight =
+        -std::log(violationProbability) / budget * delay * pf.m_potentialTputDl / std::max(pf.m_avgTputDl, 1e-9);
+    // Largest weight first
+    m_keys[ue.first.get()] = -weight;
+}
+
+DelayAwareOrdering::Compare
+DelayAwareOrdering::GetCompare() const
+{
+    return [this](const UePtrAndBufferReq& lhs, const UePtrAndBufferReq& rhs) {
+        double lhsKey = m_keys.at(lhs.first.get());
+        double rhsKey = m_keys.at(rhs.first.get());
+        if (lhsKey != rhsKey)
+        {
+            return lhsKey < rhsKey;
+        }
+        return ComparePf(lhs, rhs);
+    };
+}
+
+void
+DelayAwareOrdering::Clear()
+{
+    m_keys.clear();
+}
+
+TypeId
+NrMacSchedulerTdmaEdf::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::NrMacSchedulerTdmaEdf")
+                            .SetParent<NrMacSchedulerTdmaPF>()
+                            .AddConstructor<NrMacSchedulerTdmaEdf>();
+    return tid;
+}
+
+std::function<bool(const NrMacSchedulerNs3::UePtrAndBufferReq& lhs,
+                   const NrMacSchedulerNs3::UePtrAndBufferReq& rhs)>
+NrMacSchedulerTdmaEdf::GetUeCompareDlFn() const
+{
+    return m_ordering.GetCompare();
+}
+
+NrMacSchedulerNs3::BeamSymbolMap
+NrMacSchedulerTdmaEdf::AssignDLRBG(uint32_t symAvail, const ActiveUeMap& activeDl) const
+{
+    m_ordering.Clear();
+    return NrMacSchedulerTdmaPF::AssignDLRBG(symAvail, activeDl);
+}
+
+void
+NrMacSchedulerTdmaEdf::BeforeDlSched(const UePtrAndBufferReq& ue, const FTResources& assignableInIteration) const
+{
+    NrMacSchedulerTdmaPF::BeforeDlSched(ue, assignableInIteration);
+    m_ordering.UpdateEdf(ue);
+}
+
+TypeId
+NrMacSchedulerTdmaMlwdf::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::NrMacSchedulerTdmaMlwdf")
+            .SetParent<NrMacSchedulerTdmaPF>()
+            .AddConstructor<NrMacSchedulerTdmaMlwdf>()
+            .AddAttribute("ViolationProbability",
+                          "Target probability of exceeding the delay budget",
+                          DoubleValue(0.05),
+                          MakeDoubleAccessor(&NrMacSchedulerTdmaMlwdf::m_violationProbability),
+                          MakeDoubleChecker<double>(1e-9, 1.0));
+    return tid;
+}
+
+std::function<bool(const NrMacSchedulerNs3::UePtrAndBufferReq& lhs,
+                   const NrMacSchedulerNs3::UePtrAndBufferReq& rhs)>
+NrMacSchedulerTdmaMlwdf::GetUeCompareDlFn() const
+{
+    return m_ordering.GetCompare();
+}
+
+NrMacSchedulerNs3::BeamSymbolMap
+NrMacSchedulerTdmaMlwdf::AssignDLRBG(uint32_t symAvail, const ActiveUeMap& activeDl) const
+{
+    m_ordering.Clear();
+    return NrMacSchedulerTdmaPF::AssignDLRBG(symAvail, activeDl);
+}
+
+void
+NrMacSchedulerTdmaMlwdf::BeforeDlSched(const UePtrAndBufferReq& ue, const FTResources& assignableInIteration) const
+{
+    NrMacSchedulerTdmaPF::BeforeDlSched(ue, assignableInIteration);
+    m_ordering.UpdateMlwdf(ue, m_violationProbability);
+}
+
+TypeId
+NrMacSchedulerOfdmaEdf::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::NrMacSchedulerOfdmaEdf")
+                            .SetParent<NrMacSchedulerOfdmaPF>()
+                            .AddConstructor<NrMacSchedulerOfdmaEdf>();
+    return tid;
+}
+
+std::function<bool(const NrMacSchedulerNs3::UePtrAndBufferReq& lhs,
+                   const NrMacSchedulerNs3::UePtrAndBufferReq& rhs)>
+NrMacSchedulerOfdmaEdf::GetUeCompareDlFn() const
+{
+    return m_ordering.GetCompare();
+}
+
+NrMacSchedulerNs3::BeamSymbolMap
+NrMacSchedulerOfdmaEdf::AssignDLRBG(uint32_t symAvail, const ActiveUeMap& activeDl) const
+{
+    m_ordering.Clear();
+    return NrMacSchedulerOfdmaPF::AssignDLRBG(symAvail, activeDl);
+}
+
+void
+NrMacSchedulerOfdmaEdf::BeforeDlSched(const UePtrAndBufferReq& ue, const FTResources& assignableInIteration) const
+{
+    NrMacSchedulerOfdmaPF::BeforeDlSched(ue, assignableInIteration);
+    m_ordering.UpdateEdf(ue);
+}
+
+TypeId
+NrMacSchedulerOfdmaMlwdf::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::NrMacSchedulerOfdmaMlwdf")
+            .SetParent<NrMacSchedulerOfdmaPF>()
+            .AddConstructor<NrMacSchedulerOfdmaMlwdf>()
+            .AddAttribute("ViolationProbability",
+                          "Target probability of exceeding the delay budget",
+                          DoubleValue(0.05),
+                          MakeDoubleAccessor(&NrMacSchedulerOfdmaMlwdf::m_violationProbability),
+                          MakeDoubleChecker<double>(1e-9, 1.0));
+    return tid;
+}
+
+std::function<bool(const NrMacSchedulerNs3::UePtrAndBufferReq& lhs,
+                   const NrMacSchedulerNs3::UePtrAndBufferReq& rhs)>
+NrMacSchedulerOfdmaMlwdf::GetUeCompareDlFn() const
+{
+    return m_ordering.GetCompare();
+}
+
+NrMacSchedulerNs3::BeamSymbolMap
+NrMacSchedulerOfdmaMlwdf::AssignDLRBG(uint32_t symAvail, const ActiveUeMap& activeDl) const
+{
+    m_ordering.Clear();
+    return NrMacSchedulerOfdmaPF::AssignDLRBG(symAvail, activeDl);
+}
+
+void
+NrMacSchedulerOfdmaMlwdf::BeforeDlSched(const UePtrAndBufferReq& ue, const FTResources& assignableInIteration) const
+{
+    NrMacSchedulerOfdmaPF::BeforeDlSched(ue, assignableInIteration);
+    m_ordering.UpdateMlwdf(ue, m_violationProbability);
+}
+
+} // namespace ns3
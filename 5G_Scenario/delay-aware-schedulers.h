@@ -0,0 +1,124 @@
+#ifndef DELAY_AWARE_SCHEDULERS_H
+#define DELAY_AWARE_SCHEDULERS_H
+
+#include "ns3/nr-mac-scheduler-ofdma-pf.h"
+#include "ns3/nr-mac-scheduler-tdma-pf.h"
+
+#include <unordered_map>
+
+namespace ns3
+{
+
+/**
+ * Downlink UE ordering on the head of line delay of the RLC queues.
+ *
+ * The schedulers below derive from the PF ones, which keep computing the
+ * potential and average throughput of every UE, and only replace the
+ * downlink ordering:
+ *
+ * - EDF serves first the UE whose oldest queued packet is closest to its
+ *   delay budget (budget of the QCI minus head of line delay), PF breaks ties
+ * - M-LWDF serves first the UE with the largest a * HOL * r / R, where HOL is
+ *   the head of line delay, r the potential and R the average throughput and
+ *   a = -log(delta) / budget for a target violation probability delta
+ *
+ * The key of every UE is computed once in BeforeDlSched, which the TDMA and
+ * OFDMA schedulers call for every UE before each sort, and the comparison
+ * only looks it up.
+ *
+ * The uplink keeps the PF ordering: the gNB only sees buffer status reports,
+ * not the age of the packets in the UE.
+ */
+class DelayAwareOrdering
+{
+  public:
+    using UePtrAndBufferReq = NrMacSchedulerNs3::UePtrAndBufferReq;
+    using Compare = std::function<bool(const UePtrAndBufferReq&, const UePtrAndBufferReq&)>;
+
+    /// Cache the EDF key of a UE: the smallest slack among its active downlink LCs
+    void UpdateEdf(const UePtrAndBufferReq& ue);
+    /// Cache the M-LWDF key of a UE, after its potential throughput was updated
+    void UpdateMlwdf(const UePtrAndBufferReq& ue, double violationProbability);
+    /// Smallest cached key first, PF breaks ties
+    Compare GetCompare() const;
+    /// Forget the keys, at the start of every downlink assignment, so that
+    /// released or handed over UEs do not leave theirs behind
+    void Clear();
+
+    /// Head of line delay in ms and its delay budget, of the most urgent active downlink LC
+    static void GetMostUrgent(const NrMacSchedulerUeInfo& ue, double* holDelay, double* budget);
+
+  private:
+    /// Key of every active UE, computed once per UE before each sort (BeforeDlSched)
+    std::unordered_map<const NrMacSchedulerUeInfo*, double> m_keys;
+};
+
+/// TDMA earliest deadline first scheduler
+class NrMacSchedulerTdmaEdf : public NrMacSchedulerTdmaPF
+{
+  public:
+    static TypeId GetTypeId();
+
+  protected:
+    std::function<bool(const UePtrAndBufferReq& lhs, const UePtrAndBufferReq& rhs)> GetUeCompareDlFn()
+        const override;
+    BeamSymbolMap AssignDLRBG(uint32_t symAvail, const ActiveUeMap& activeDl) const override;
+    void BeforeDlSched(const UePtrAndBufferReq& ue, const FTResources& assignableInIteration) const override;
+
+  private:
+    mutable DelayAwareOrdering m_ordering;
+};
+
+/// TDMA M-LWDF scheduler
+class NrMacSchedulerTdmaMlwdf : public NrMacSchedulerTdmaPF
+{
+  public:
+    static TypeId GetTypeId();
+
+  protected:
+    std::function<bool(const UePtrAndBufferReq& lhs, const UePtrAndBufferReq& rhs)> GetUeCompareDlFn()
+        const override;
+    BeamSymbolMap AssignDLRBG(uint32_t symAvail, const ActiveUeMap& activeDl) const override;
+    void BeforeDlSched(const UePtrAndBufferReq& ue, const FTResources& assignableInIteration) const override;
+
+  private:
+    double m_violationProbability;
+    mutable DelayAwareOrdering m_ordering;
+};
+
+/// OFDMA earliest deadline first scheduler
+class NrMacSchedulerOfdmaEdf : public NrMacSchedulerOfdmaPF
+{
+  public:
+    static TypeId GetTypeId();
+
+  protected:
+    std::function<bool(const UePtrAndBufferReq& lhs, const UePtrAndBufferReq& rhs)> GetUeCompareDlFn()
+        const override;
+    BeamSymbolMap AssignDLRBG(uint32_t symAvail, const ActiveUeMap& activeDl) const override;
+    void BeforeDlSched(const UePtrAndBufferReq& ue, const FTResources& assignableInIteration) const override;
+
+  private:
+    mutable DelayAwareOrdering m_ordering;
+};
+
+/// OFDMA M-LWDF scheduler
+class NrMacSchedulerOfdmaMlwdf : public NrMacSchedulerOfdmaPF
+{
+  public:
+    static TypeId GetTypeId();
+
+  protected:
+    std::function<bool(const UePtrAndBufferReq& lhs, const UePtrAndBufferReq& rhs)> GetUeCompareDlFn()
+        const override;
+    BeamSymbolMap AssignDLRBG(uint32_t symAvail, const ActiveUeMap& activeDl) const override;
+    void BeforeDlSched(const UePtrAndBufferReq& ue, const FTResources& assignableInIteration) const override;
+
+  private:
+    double m_violationProbability;
+    mutable DelayAwareOrdering m_ordering;
+};
+
+} // namespace ns3
+
+#endif // DELAY_AWARE_SCHEDULERS_H
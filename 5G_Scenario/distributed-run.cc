@@ -0,0 +1,77 @@
+#include "distributed-run.h"
+
+#include "ns3/abort.h"
+#include "ns3/global-value.h"
+#include "ns3/string.h"
+
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#endif
+
+namespace ns3
+{
+
+DistributedRun::DistributedRun(bool enabled, int* argc, char*** argv)
+    : m_enabled(enabled)
+{
+    if (!enabled)
+    {
+        return;
+    }
+#ifdef NS3_MPI
+    GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::DistributedSimulatorImpl"));
+    MpiInterface::Enable(argc, argv);
+    m_rank = MpiInterface::GetSystemId();
+    m_size = MpiInterface::GetSize();
+#else
+    NS_ABORT_MSG("--distributed needs ns-3 configured with --enable-mpi");
+#endif
+}
+
+DistributedRun::~DistributedRun()
+{
+#ifdef NS3_MPI
+    if (m_enabled)
+    {
+        MpiInterface::Disable();
+    }
+#endif
+}
+
+bool
+DistributedRun::IsEnabled() const
+{
+    return m_enabled;
+}
+
+uint32_t
+DistributedRun::GetRank() const
+{
+    return m_rank;
+}
+
+uint32_t
+DistributedRun::GetSize() const
+{
+    return m_size;
+}
+
+uint32_t
+DistributedRun::GetRemoteHostRank() const
+{
+    return m_size > 1 ? 1 : 0;
+}
+
+bool
+DistributedRun::IsLocal(Ptr<Node> node) const
+{
+    return node->GetSystemId() == m_rank;
+}
+
+bool
+DistributedRun::IsReportingRank() const
+{
+    return m_rank == 0;
+}
+
+} // namespace ns3
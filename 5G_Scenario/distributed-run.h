@@ -0,0 +1,56 @@
+#ifndef DISTRIBUTED_RUN_H
+#define DISTRIBUTED_RUN_H
+
+#include "ns3/node.h"
+#include "ns3/ptr.h"
+
+#include <cstdint>
+
+namespace ns3
+{
+
+/**
+ * Splits the scenario over MPI ranks with the ns-3 distributed simulator.
+ *
+ * The RAN shares a single spectrum channel and the EPC nodes are created by
+ * NrPointToPointEpcHelper on rank 0, so the only link that can be cut is the
+ * point-to-point link between the PGW and the remote host: the remote host
+ * and its UDP clients run on rank 1, everything else on rank 0, and the delay
+ * of that link is the lookahead. Ranks above 1 have no nodes. Every rank
+ * builds the whole topology; applications are installed on the nodes owned
+ * by the local rank only and rank 0 prints the results.
+ *
+ * Without --distributed, or when ns-3 was built without MPI, there is a
+ * single rank owning every node.
+ */
+class DistributedRun
+{
+  public:
+    /// Enable MPI and the distributed simulator if `enabled`, aborting without MPI support
+    DistributedRun(bool enabled, int* argc, char*** argv);
+    /// Shut MPI down, after Simulator::Destroy()
+    ~DistributedRun();
+
+    DistributedRun(const DistributedRun&) = delete;
+    DistributedRun& operator=(const DistributedRun&) = delete;
+
+    bool IsEnabled() const;
+    uint32_t GetRank() const;
+    uint32_t GetSize() const;
+
+    /// Rank owning the remote host: 1 when distributed over two or more ranks
+    uint32_t GetRemoteHostRank() const;
+    /// Whether the node is simulated by this rank
+    bool IsLocal(Ptr<Node> node) const;
+    /// Whether this rank prints the results
+    bool IsReportingRank() const;
+
+  private:
+    bool m_enabled{false};
+    uint32_t m_rank{0};
+    uint32_t m_size{1};
+};
+
+} // namespace ns3
+
+#endif // DISTRIBUTED_RUN_H
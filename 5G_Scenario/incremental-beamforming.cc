@@ -0,0 +1,179 @@
+#include "incremental-beamforming.h"
+
+#include "ns3/angles.h"
+#include "ns3/double.h"
+#include "ns3/mobility-model.h"
+#include "ns3/nr-spectrum-phy.h"
+#include "ns3/uniform-planar-array.h"
+
+#include <cmath>
+#include <complex>
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(IncrementalDirectPathBeamforming);
+
+std::set<const IncrementalDirectPathBeamforming*> IncrementalDirectPathBeamforming::s_instances;
+
+namespace
+{
+
+// Angle between two directions in degrees
+double
+AngleBetween(const Vector& a, const Vector& b)
+{
+    double lengths = a.GetLength() * b.GetLength();
+    if (lengths <= 0)
+    {
+        return 0.0;
+    }
+    double cosine = (a.x * b.x + a.y * b.y + a.z * b.z) / lengths;
+    return std::acos(std::max(-1.0, std::min(1.0, cosine))) * 180.0 / M_PI;
+}
+
+} // namespace
+
+TypeId
+IncrementalDirectPathBeamforming::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::IncrementalDirectPathBeamforming")
+            .SetParent<DirectPathBeamforming>()
+            .AddConstructor<IncrementalDirectPathBeamforming>()
+            .AddAttribute("AngleThreshold",
+                          "Recompute the beams of a pair once its direction changed by more "
+                          "than this many degrees (0 recomputes every time)",
+                          DoubleValue(1.0),
+                          MakeDoubleAccessor(&IncrementalDirectPathBeamforming::m_angleThreshold),
+                          MakeDoubleChecker<double>(0.0));
+    return tid;
+}
+
+IncrementalDirectPathBeamforming::IncrementalDirectPathBeamforming()
+{
+    s_instances.insert(this);
+}
+
+IncrementalDirectPathBeamforming::~IncrementalDirectPathBeamforming()
+{
+    s_instances.erase(this);
+}
+
+IncrementalDirectPathBeamforming::Statistics&
+IncrementalDirectPathBeamforming::Statistics::operator+=(const Statistics& other)
+{
+    computed += other.computed;
+    skipped += other.skipped;
+    steeringVectors += other.steeringVectors;
+    callTime += other.callTime;
+    return *this;
+}
+
+const IncrementalDirectPathBeamforming::Statistics&
+IncrementalDirectPathBeamforming::GetStatistics() const
+{
+    return m_statistics;
+}
+
+IncrementalDirectPathBeamforming::Statistics
+IncrementalDirectPathBeamforming::GetTotalStatistics()
+{
+    Statistics total;
+    for (const auto* instance : s_instances)
+    {
+        total += instance->m_statistics;
+    }
+    return total;
+}
+
+PhasedArrayModel::ComplexVector
+IncrementalDirectPathBeamforming::GetWeights(const Ptr<const PhasedArrayModel>& antenna,
+                                             const Vector& from,
+                                             const Vector& to) const
+{
+    // Quantize the direction to half the threshold
+    Angles angles(to, from);
+    double step = m_angleThreshold / 2 * M_PI / 180.0;
+    int64_t azimuthIndex = std::llround(angles.GetAzimuth() / step);
+    int64_t inclinationIndex = std::llround(angles.GetInclination() / step);
+
+    std::size_t elements = antenna->GetNumElems();
+    Vector last = antenna->GetElementLocation(elements - 1);
+    Geometry geometry{elements,
+                      std::llround(last.x * 1000),
+                      std::llround(last.y * 1000),
+                      std::llround(last.z * 1000)};
+
+    auto key = std::make_tuple(geometry, azimuthIndex, inclinationIndex);
+    auto it = m_steering.find(key);
+    if (it != m_steering.end())
+    {
+        return it->second;
+    }
+
+    // Same weights as CreateDirectPathBfv(), for the quantized angles
+    double azimuth = azimuthIndex * step;
+    double inclination = inclinationIndex * step;
+    double power = 1 / std::sqrt(elements);
+    PhasedArrayModel::ComplexVector weights(elements);
+    for (std::size_t i = 0; i < elements; ++i)
+    {
+        Vector location = antenna->GetElementLocation(i);
+        double phase = -2 * M_PI *
+                       (std::sin(inclination) * std::cos(azimuth) * location.x +
+                        std::sin(inclination) * std::sin(azimuth) * location.y +
+                        std::cos(inclination) * location.z);
+        weights[i] = std::exp(std::complex<double>(0, phase)) * power;
+    }
+    ++m_statistics.steeringVectors;
+    return m_steering.emplace(key, weights).first->second;
+}
+
+void
+IncrementalDirectPathBeamforming::GetBeamformingVectors(const Ptr<const NrSpectrumPhy>& gnbSpectrumPhy,
+                                                        const Ptr<const NrSpectrumPhy>& ueSpectrumPhy,
+                                                        BeamformingVector* gnbBfv,
+                                                        BeamformingVector* ueBfv) const
+{
+    auto start = std::chrono::steady_clock::now();
+    if (m_angleThreshold <= 0)
+    {
+        DirectPathBeamforming::GetBeamformingVectors(gnbSpectrumPhy, ueSpectrumPhy, gnbBfv, ueBfv);
+        ++m_statistics.computed;
+        m_statistics.callTime += std::chrono::steady_clock::now() - start;
+        return;
+    }
+
+    Vector gnbPosition = gnbSpectrumPhy->GetMobility()->GetPosition();
+    Vector uePosition = ueSpectrumPhy->GetMobility()->GetPosition();
+    Vector direction = uePosition - gnbPosition;
+
+    auto key = std::make_pair(PeekPointer(gnbSpectrumPhy), PeekPointer(ueSpectrumPhy));
+    auto it = m_pairs.find(key);
+    if (it != m_pairs.end() && AngleBetween(it->second.direction, direction) <= m_angleThreshold)
+    {
+        *gnbBfv = it->second.gnbBfv;
+        *ueBfv = it->second.ueBfv;
+        ++m_statistics.skipped;
+        m_statistics.callTime += std::chrono::steady_clock::now() - start;
+        return;
+    }
+
+    Ptr<const PhasedArrayModel> gnbAntenna = gnbSpectrumPhy->GetAntenna()->GetObject<UniformPlanarArray>();
+    Ptr<const PhasedArrayModel> ueAntenna = ueSpectrumPhy->GetAntenna()->GetObject<UniformPlanarArray>();
+
+    PairBeams& beams = m_pairs[key];
+    beams.direction = direction;
+    beams.gnbBfv = BeamformingVector(std::make_pair(GetWeights(gnbAntenna, gnbPosition, uePosition),
+                                                    BeamId::GetEmptyBeamId()));
+    beams.ueBfv = BeamformingVector(std::make_pair(GetWeights(ueAntenna, uePosition, gnbPosition),
+                                                   BeamId::GetEmptyBeamId()));
+    *gnbBfv = beams.gnbBfv;
+    *ueBfv = beams.ueBfv;
+
+    ++m_statistics.computed;
+    m_statistics.callTime += std::chrono::steady_clock::now() - start;
+}
+
+} // namespace ns3
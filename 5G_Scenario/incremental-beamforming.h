@@ -0,0 +1,84 @@
+#ifndef INCREMENTAL_BEAMFORMING_H
+#define INCREMENTAL_BEAMFORMING_H
+
+#include "ns3/ideal-beamforming-algorithm.h"
+#include "ns3/phased-array-model.h"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <tuple>
+#include <utility>
+
+namespace ns3
+{
+
+/**
+ * DirectPathBeamforming that only recomputes the beams of a gNB/UE pair
+ * when the direction between them changed by more than AngleThreshold
+ * degrees since the last computation.
+ *
+ * New beams are computed for the direction quantized to half the threshold,
+ * and the steering vectors are cached per array geometry (number of
+ * elements and extent) and quantized angle, so the 4x8 gNB and 2x4 UE arrays
+ * of every node share the same table. A zero threshold falls back to
+ * DirectPathBeamforming, still timed, which makes it the baseline the
+ * handler time of a threshold is compared with.
+ */
+class IncrementalDirectPathBeamforming : public DirectPathBeamforming
+{
+  public:
+    /// Beams computed and reused, and the wall time of all the calls
+    struct Statistics
+    {
+        uint64_t computed{0};
+        uint64_t skipped{0};
+        uint64_t steeringVectors{0};
+        std::chrono::steady_clock::duration callTime{0};
+
+        Statistics& operator+=(const Statistics& other);
+    };
+
+    static TypeId GetTypeId();
+
+    IncrementalDirectPathBeamforming();
+    ~IncrementalDirectPathBeamforming() override;
+
+    void GetBeamformingVectors(const Ptr<const NrSpectrumPhy>& gnbSpectrumPhy,
+                               const Ptr<const NrSpectrumPhy>& ueSpectrumPhy,
+                               BeamformingVector* gnbBfv,
+                               BeamformingVector* ueBfv) const override;
+
+    /// Counters of this instance
+    const Statistics& GetStatistics() const;
+    /// Sum of the counters of the live instances (the helper owns them)
+    static Statistics GetTotalStatistics();
+
+  private:
+    struct PairBeams
+    {
+        Vector direction;
+        BeamformingVector gnbBfv;
+        BeamformingVector ueBfv;
+    };
+
+    /// Number of elements and position of the last one, in mm
+    using Geometry = std::tuple<std::size_t, int64_t, int64_t, int64_t>;
+
+    /// Direct path weights of the antenna towards the quantized direction from a to b
+    PhasedArrayModel::ComplexVector GetWeights(const Ptr<const PhasedArrayModel>& antenna,
+                                               const Vector& from,
+                                               const Vector& to) const;
+
+    double m_angleThreshold;
+
+    mutable std::map<std::pair<const NrSpectrumPhy*, const NrSpectrumPhy*>, PairBeams> m_pairs;
+    mutable std::map<std::tuple<Geometry, int64_t, int64_t>, PhasedArrayModel::ComplexVector> m_steering;
+    mutable Statistics m_statistics;
+    static std::set<const IncrementalDirectPathBeamforming*> s_instances;
+};
+
+} // namespace ns3
+
+#endif // INCREMENTAL_BEAMFORMING_H
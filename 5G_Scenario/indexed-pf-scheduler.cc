@@ -0,0 +1,382 @@
+#include "indexed-pf-scheduler.h"
+
+#include "ns3/boolean.h"
+#include "ns3/nr-mac-scheduler-ue-info-pf.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(NrMacSchedulerTdmaIndexedPF);
+
+namespace
+{
+
+const uint32_t g_none = std::numeric_limits<uint32_t>::max();
+// Floor of the PF metric denominator in NrMacSchedulerUeInfoPF
+const double g_minAvgTput = 1e-9;
+// Keys closer than this (in log) to the last candidate may be ties after rounding
+const double g_keyTolerance = 1e-6;
+
+} // namespace
+
+void
+IndexedMaxHeap::Push(uint32_t id, double key, uint32_t tie)
+{
+    if (id >= m_position.size())
+    {
+        m_position.resize(id + 1, g_none);
+        m_key.resize(id + 1);
+        m_tie.resize(id + 1);
+    }
+    m_key[id] = key;
+    m_tie[id] = tie;
+    m_heap.push_back(id);
+    m_position[id] = m_heap.size() - 1;
+    SiftUp(m_heap.size() - 1);
+}
+
+void
+IndexedMaxHeap::Remove(uint32_t id)
+{
+    std::size_t position = m_position[id];
+    uint32_t last = m_heap.back();
+    m_heap.pop_back();
+    m_position[id] = g_none;
+    if (position < m_heap.size())
+    {
+        Place(position, last);
+        SiftUp(position);
+        SiftDown(m_position[last]);
+    }
+}
+
+bool
+IndexedMaxHeap::Contains(uint32_t id) const
+{
+    return id < m_position.size() && m_position[id] != g_none;
+}
+
+bool
+IndexedMaxHeap::IsEmpty() const
+{
+    return m_heap.empty();
+}
+
+uint32_t
+IndexedMaxHeap::Top() const
+{
+    return m_heap.front();
+}
+
+double
+IndexedMaxHeap::GetKey(uint32_t id) const
+{
+    return m_key[id];
+}
+
+const std::vector<uint32_t>&
+IndexedMaxHeap::GetIds() const
+{
+    return m_heap;
+}
+
+bool
+IndexedMaxHeap::Above(uint32_t a, uint32_t b) const
+{
+    return m_key[a] > m_key[b] || (m_key[a] == m_key[b] && m_tie[a] < m_tie[b]);
+}
+
+void
+IndexedMaxHeap::Place(std::size_t position, uint32_t id)
+{
+    m_heap[position] = id;
+    m_position[id] = position;
+}
+
+void
+IndexedMaxHeap::SiftUp(std::size_t position)
+{
+    uint32_t id = m_heap[position];
+    while (position > 0)
+    {
+        std::size_t parent = (position - 1) / 2;
+        if (!Above(id, m_heap[parent]))
+        {
+            break;
+        }
+        Place(position, m_heap[parent]);
+        position = parent;
+    }
+    Place(position, id);
+}
+
+void
+IndexedMaxHeap::SiftDown(std::size_t position)
+{
+    uint32_t id = m_heap[position];
+    std::size_t size = m_heap.size();
+    while (true)
+    {
+        std::size_t child = 2 * position + 1;
+        if (child >= size)
+        {
+            break;
+        }
+        if (child + 1 < size && Above(m_heap[child + 1], m_heap[child]))
+        {
+            ++child;
+        }
+        if (!Above(m_heap[child], id))
+        {
+            break;
+        }
+        Place(position, m_heap[child]);
+        position = child;
+    }
+    Place(position, id);
+}
+
+TypeId
+NrMacSchedulerTdmaIndexedPF::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::NrMacSchedulerTdmaIndexedPF")
+            .SetParent<NrMacSchedulerTdmaPF>()
+            .AddConstructor<NrMacSchedulerTdmaIndexedPF>()
+            .AddAttribute("UseIndex",
+                          "Select the UEs of every slot from the indexed heap (false sorts all "
+                          "of them every symbol, as the TDMA PF scheduler)",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&NrMacSchedulerTdmaIndexedPF::m_useIndex),
+                          MakeBooleanChecker());
+    return tid;
+}
+
+std::function<bool(const NrMacSchedulerNs3::UePtrAndBufferReq& lhs,
+                   const NrMacSchedulerNs3::UePtrAndBufferReq& rhs)>
+NrMacSchedulerTdmaIndexedPF::GetUeCompareDlFn() const
+{
+    return [](const UePtrAndBufferReq& lhs, const UePtrAndBufferReq& rhs) {
+        if (NrMacSchedulerUeInfoPF::CompareUeWeightsDl(lhs, rhs))
+        {
+            return true;
+        }
+        if (NrMacSchedulerUeInfoPF::CompareUeWeightsDl(rhs, lhs))
+        {
+            return false;
+        }
+        return lhs.first->m_rnti < rhs.first->m_rnti;
+    };
+}
+
+uint32_t
+NrMacSchedulerTdmaIndexedPF::GetIndex(uint16_t rnti) const
+{
+    if (m_indexOfRnti.empty())
+    {
+        m_indexOfRnti.resize(std::numeric_limits<uint16_t>::max() + 1, g_none);
+    }
+    uint32_t& id = m_indexOfRnti[rnti];
+    if (id == g_none)
+    {
+        id = m_rnti.size();
+        m_rnti.push_back(rnti);
+        m_mcs.push_back(0);
+        m_logRate.push_back(0.0);
+        m_activeSlot.push_back(0);
+        m_candidateSlot.push_back(0);
+    }
+    return id;
+}
+
+double
+NrMacSchedulerTdmaIndexedPF::GetDecay() const
+{
+    return m_decays * m_logDecay;
+}
+
+void
+NrMacSchedulerTdmaIndexedPF::Rekey(uint32_t id, double avgTput) const
+{
+    if (m_served.Contains(id))
+    {
+        m_served.Remove(id);
+    }
+    if (m_unserved.Contains(id))
+    {
+        m_unserved.Remove(id);
+    }
+    if (avgTput <= g_minAvgTput)
+    {
+        m_unserved.Push(id, m_logRate[id] - std::log(g_minAvgTput), m_rnti[id]);
+    }
+    else
+    {
+        m_served.Push(id, m_logRate[id] - std::log(avgTput) - GetDecay(), m_rnti[id]);
+    }
+}
+
+bool
+NrMacSchedulerTdmaIndexedPF::GetBest(uint32_t* id, double* key) const
+{
+    if (m_served.IsEmpty() && m_unserved.IsEmpty())
+    {
+        return false;
+    }
+    if (m_unserved.IsEmpty())
+    {
+        *id = m_served.Top();
+        *key = m_served.GetKey(*id) + GetDecay();
+        return true;
+    }
+    uint32_t unserved = m_unserved.Top();
+    double unservedKey = m_unserved.GetKey(unserved);
+    if (!m_served.IsEmpty())
+    {
+        uint32_t served = m_served.Top();
+        double servedKey = m_served.GetKey(served) + GetDecay();
+        if (servedKey > unservedKey || (servedKey == unservedKey && m_rnti[served] < m_rnti[unserved]))
+        {
+            *id = served;
+            *key = servedKey;
+            return true;
+        }
+    }
+    *id = unserved;
+    *key = unservedKey;
+    return true;
+}
+
+NrMacSchedulerNs3::BeamSymbolMap
+NrMacSchedulerTdmaIndexedPF::AssignDLRBG(uint32_t symAvail, const ActiveUeMap& activeDl) const
+{
+    if (!m_useIndex)
+    {
+        return NrMacSchedulerTdmaPF::AssignDLRBG(symAvail, activeDl);
+    }
+
+    ++m_slot;
+    m_logDecay = -std::log(1.0 - 1.0 / GetTimeWindow());
+    const auto& notched = GetDlNotchedRbgMask();
+    uint32_t assignableRbgs = GetBandwidthInRbg() - std::count(notched.begin(), notched.end(), 0);
+
+    // Re-key only the UEs that just became active or whose MCS changed
+    for (const auto& beam : activeDl)
+    {
+        for (const auto& ue : beam.second)
+        {
+            auto pf = std::static_pointer_cast<NrMacSchedulerUeInfoPF>(ue.first);
+            uint32_t id = GetIndex(pf->m_rnti);
+            m_activeSlot[id] = m_slot;
+            bool known = m_served.Contains(id) || m_unserved.Contains(id);
+            if (known && m_mcs[id] == pf->m_dlMcs)
+            {
+                continue;
+            }
+            m_mcs[id] = pf->m_dlMcs;
+            pf->CalculatePotentialTPutDl(FTResources(assignableRbgs, 1), m_dlAmc);
+            m_logRate[id] = std::log(std::pow(pf->m_potentialTputDl, pf->m_alpha));
+            Rekey(id, pf->m_avgTputDl);
+        }
+    }
+
+    // Drop the UEs without data in this slot, they are re-keyed when they return
+    std::vector<uint32_t> inactive;
+    for (const IndexedMaxHeap* heap : {&m_served, &m_unserved})
+    {
+        for (uint32_t id : heap->GetIds())
+        {
+            if (m_activeSlot[id] != m_slot)
+            {
+                inactive.push_back(id);
+            }
+        }
+    }
+    for (uint32_t id : inactive)
+    {
+        (m_served.Contains(id) ? m_served : m_unserved).Remove(id);
+    }
+
+    // The symAvail best UEs, and whatever ties with the last of them
+    m_candidates.clear();
+    uint32_t best;
+    double key;
+    double lastKey = 0;
+    while (GetBest(&best, &key))
+    {
+        if (m_candidates.size() >= symAvail && key < lastKey - g_keyTolerance)
+        {
+            break;
+        }
+        (m_served.Contains(best) ? m_served : m_unserved).Remove(best);
+        m_candidates.push_back(best);
+        m_candidateSlot[best] = m_slot;
+        if (m_candidates.size() <= symAvail)
+        {
+            lastKey = key;
+        }
+    }
+
+    ActiveUeMap candidates;
+    for (const auto& beam : activeDl)
+    {
+        for (const auto& ue : beam.second)
+        {
+            if (m_candidateSlot[GetIndex(ue.first->m_rnti)] == m_slot)
+            {
+                candidates[beam.first].push_back(ue);
+            }
+        }
+    }
+    BeamSymbolMap assigned = NrMacSchedulerTdmaPF::AssignDLRBG(symAvail, candidates);
+
+    // Same map, and insertion order, as the assignment over all the UEs
+    BeamSymbolMap symPerBeam;
+    uint32_t assignedSym = 0;
+    for (const auto& beam : activeDl)
+    {
+        auto it = assigned.find(beam.first);
+        uint32_t sym = it != assigned.end() ? it->second : 0;
+        symPerBeam.insert({beam.first, sym});
+        assignedSym += sym;
+    }
+
+    // The UEs served in the slot get new keys. The others only see their
+    // average throughput decay, once per slot instead of once per symbol,
+    // which leaves them at the same key unless they reach the floor
+    if (assignedSym > 0)
+    {
+        ++m_decays;
+    }
+    FTResources total(assignedSym * assignableRbgs, assignedSym);
+    for (const auto& beam : activeDl)
+    {
+        for (const auto& ue : beam.second)
+        {
+            auto pf = std::static_pointer_cast<NrMacSchedulerUeInfoPF>(ue.first);
+            uint32_t id = GetIndex(pf->m_rnti);
+            if (m_candidateSlot[id] == m_slot)
+            {
+                Rekey(id, pf->m_avgTputDl);
+                continue;
+            }
+            if (assignedSym == 0)
+            {
+                continue;
+            }
+            NotAssignedDlResources(ue, FTResources(assignableRbgs, 1), total);
+            if (m_served.Contains(id) && pf->m_avgTputDl <= g_minAvgTput)
+            {
+                Rekey(id, pf->m_avgTputDl);
+            }
+        }
+    }
+
+    return symPerBeam;
+}
+
+} // namespace ns3
@@ -0,0 +1,109 @@
+#ifndef INDEXED_PF_SCHEDULER_H
+#define INDEXED_PF_SCHEDULER_H
+
+#include "ns3/nr-mac-scheduler-tdma-pf.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Binary max-heap of dense ids whose keys can be updated or removed in
+ * O(log n). Ids, keys and heap positions are kept in flat arrays; equal
+ * keys are ordered on the lower tie value.
+ */
+class IndexedMaxHeap
+{
+  public:
+    void Push(uint32_t id, double key, uint32_t tie);
+    void Remove(uint32_t id);
+    bool Contains(uint32_t id) const;
+    bool IsEmpty() const;
+    /// Id with the largest key, the heap must not be empty
+    uint32_t Top() const;
+    double GetKey(uint32_t id) const;
+    /// Ids in heap order
+    const std::vector<uint32_t>& GetIds() const;
+
+  private:
+    bool Above(uint32_t a, uint32_t b) const;
+    void Place(std::size_t position, uint32_t id);
+    void SiftUp(std::size_t position);
+    void SiftDown(std::size_t position);
+
+    std::vector<uint32_t> m_heap;
+    std::vector<uint32_t> m_position;
+    std::vector<double> m_key;
+    std::vector<uint32_t> m_tie;
+};
+
+/**
+ * TDMA proportional fair scheduler that does not sort all the UEs every
+ * symbol.
+ *
+ * Within a slot, every UE that has not been served yet only sees its average
+ * throughput decay by the same factor, so their PF order does not change:
+ * the UEs served in a slot of S symbols are always among the S first ones at
+ * the start of the slot. The UEs are kept in an indexed heap on
+ * log(r^alpha) - log(R), relative to the accumulated log decay so that the
+ * decay of the UEs that were not served does not move them; only the UEs
+ * served in the slot, the ones whose MCS changed and the ones that joined or
+ * left the active set are re-keyed. Every slot the S best UEs (and any UE
+ * within rounding distance of the last of them) are handed to the regular
+ * TDMA PF assignment, and the others only get the single average throughput
+ * update they would have received.
+ *
+ * The UEs below the 1e-9 floor of the PF metric denominator (never served)
+ * have a constant metric and live in a second heap.
+ *
+ * Ties of the PF metric are broken on the lower RNTI, so the order is total
+ * and UseIndex=false (the TDMA PF assignment over all the UEs, with the same
+ * order) is the reference the indexed version must match slot by slot. This
+ * is the one deviation from NrMacSchedulerTdmaPF, which leaves equal metrics
+ * in the iteration order of its UE hash map: that order is not reproducible
+ * by a heap, and any fixed order is as fair as it.
+ */
+class NrMacSchedulerTdmaIndexedPF : public NrMacSchedulerTdmaPF
+{
+  public:
+    static TypeId GetTypeId();
+
+  protected:
+    BeamSymbolMap AssignDLRBG(uint32_t symAvail, const ActiveUeMap& activeDl) const override;
+
+    std::function<bool(const UePtrAndBufferReq& lhs, const UePtrAndBufferReq& rhs)> GetUeCompareDlFn()
+        const override;
+
+  private:
+    uint32_t GetIndex(uint16_t rnti) const;
+    /// Put the UE back in the heap that matches its average throughput
+    void Rekey(uint32_t id, double avgTput) const;
+    /// Accumulated log decay of the UEs that were not served
+    double GetDecay() const;
+    /// Effective key of the best UE of both heaps, false when both are empty
+    bool GetBest(uint32_t* id, double* key) const;
+
+    bool m_useIndex;
+
+    mutable IndexedMaxHeap m_served;
+    mutable IndexedMaxHeap m_unserved;
+    mutable uint64_t m_slot{0};
+    mutable uint64_t m_decays{0};
+    mutable double m_logDecay{0};
+
+    // Per UE state, by dense index
+    mutable std::vector<uint32_t> m_indexOfRnti;
+    mutable std::vector<uint16_t> m_rnti;
+    mutable std::vector<uint8_t> m_mcs;
+    mutable std::vector<double> m_logRate;
+    mutable std::vector<uint64_t> m_activeSlot;
+    mutable std::vector<uint64_t> m_candidateSlot;
+
+    mutable std::vector<uint32_t> m_candidates;
+};
+
+} // namespace ns3
+
+#endif // INDEXED_PF_SCHEDULER_H
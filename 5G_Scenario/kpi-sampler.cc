@@ -0,0 +1,116 @@
+#include "kpi-sampler.h"
+
+#include "ns3/abort.h"
+#include "ns3/simulator.h"
+
+namespace ns3
+{
+
+KpiSampler::KpiSampler(Ptr<FlowMonitor> monitor, const std::string& path, Time interval)
+    : m_monitor(monitor),
+      m_interval(interval)
+{
+    NS_ABORT_MSG_IF(!interval.IsStrictlyPositive(), "The KPI sampling interval must be positive");
+    m_writer = std::make_unique<ColumnarWriter>(path,
+                                                ColumnarWriter::Columns{
+                                                    {"time", ColumnarWriter::DOUBLE},
+                                                    {"flowId", ColumnarWriter::UINT32},
+                                                    {"txPackets", ColumnarWriter::UINT64},
+                                                    {"rxPackets", ColumnarWriter::UINT64},
+                                                    {"lostPackets", ColumnarWriter::UINT64},
+                                                    {"throughputMbps", ColumnarWriter::DOUBLE},
+                                                    {"meanDelayMs", ColumnarWriter::DOUBLE},
+                                                });
+}
+
+void
+KpiSampler::Start(Time start, Time stop)
+{
+    m_stop = stop;
+    m_event = Simulator::Schedule(start + m_interval - Simulator::Now(), &KpiSampler::Sample, this);
+}
+
+void
+KpiSampler::Finish()
+{
+    m_writer->Close();
+}
+
+void
+KpiSampler::SetSampleCallback(std::function<void(const FlowSample&)> callback)
+{
+    m_sampleCallback = callback;
+}
+
+void
+KpiSampler::SetTickCallback(std::function<void(Time)> callback)
+{
+    m_tickCallback = callback;
+}
+
+Time
+KpiSampler::GetInterval() const
+{
+    return m_interval;
+}
+
+const std::string&
+KpiSampler::GetPath() const
+{
+    return m_writer->GetPath();
+}
+
+void
+KpiSampler::Sample()
+{
+    Time now = Simulator::Now();
+    const auto& stats = m_monitor->GetFlowStats();
+    for (const auto& flow : stats)
+    {
+        Previous& previous = m_previous[flow.first];
+        uint64_t rxPackets = flow.second.rxPackets - previous.rxPackets;
+
+        FlowSample sample;
+        sample.time = now;
+        sample.flowId = flow.first;
+        sample.txPackets = flow.second.txPackets;
+        sample.rxPackets = flow.second.rxPackets;
+        sample.lostPackets = flow.second.lostPackets;
+        sample.throughputMbps =
+            (flow.second.rxBytes - previous.rxBytes) * 8.0 / m_interval.GetSeconds() / 1e6;
+        sample.meanDelayMs =
+            rxPackets > 0 ? (flow.second.delaySum - previous.delaySum).GetSeconds() * 1000 / rxPackets
+                          : 0.0;
+
+        m_writer->AppendDouble(now.GetSeconds());
+        m_writer->AppendUint32(sample.flowId);
+        m_writer->AppendUint64(sample.txPackets);
+        m_writer->AppendUint64(sample.rxPackets);
+        m_writer->AppendUint64(sample.lostPackets);
+        m_writer->AppendDouble(sample.throughputMbps);
+        m_writer->AppendDouble(sample.meanDelayMs);
+        m_writer->EndRow();
+
+        previous.txPackets = flow.second.txPackets;
+        previous.rxPackets = flow.second.rxPackets;
+        previous.rxBytes = flow.second.rxBytes;
+        previous.delaySum = flow.second.delaySum;
+
+        if (m_sampleCallback)
+        {
+            m_sampleCallback(sample);
+        }
+    }
+
+    if (m_tickCallback)
+    {
+        m_tickCallback(now);
+    }
+
+    if (now + m_interval <= m_stop)
+    {
+        m_event = Simulator::Schedule(m_interval, &KpiSampler::Sample, this);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,79 @@
+#ifndef KPI_SAMPLER_H
+#define KPI_SAMPLER_H
+
+#include "columnar-writer.h"
+
+#include "ns3/event-id.h"
+#include "ns3/flow-monitor.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * Periodic snapshot of the per-flow KPIs of a FlowMonitor.
+ *
+ * Every interval it walks the flow statistics once (O(flows) per tick) and
+ * writes one row per flow with the cumulative counters and the throughput and
+ * mean delay over the last interval to a ColumnarWriter file.
+ */
+class KpiSampler
+{
+  public:
+    /// One interval of one flow, as written to the file
+    struct FlowSample
+    {
+        Time time;
+        FlowId flowId;
+        uint64_t txPackets;
+        uint64_t rxPackets;
+        uint64_t lostPackets;
+        double throughputMbps;
+        double meanDelayMs;
+    };
+
+    KpiSampler(Ptr<FlowMonitor> monitor, const std::string& path, Time interval);
+
+    /// Sample every interval after `start`, until `stop`
+    void Start(Time start, Time stop);
+    /// Close the output file
+    void Finish();
+
+    /// Called on every sample, after it has been written
+    void SetSampleCallback(std::function<void(const FlowSample&)> callback);
+    /// Called once per tick, after the rows of all the flows have been written
+    void SetTickCallback(std::function<void(Time)> callback);
+
+    Time GetInterval() const;
+    const std::string& GetPath() const;
+
+  private:
+    struct Previous
+    {
+        uint64_t txPackets{0};
+        uint64_t rxPackets{0};
+        uint64_t rxBytes{0};
+        Time delaySum;
+    };
+
+    void Sample();
+
+    Ptr<FlowMonitor> m_monitor;
+    Time m_interval;
+    Time m_stop;
+    EventId m_event;
+    std::unique_ptr<ColumnarWriter> m_writer;
+    std::map<FlowId, Previous> m_previous;
+    std::function<void(const FlowSample&)> m_sampleCallback;
+    std::function<void(Time)> m_tickCallback;
+};
+
+} // namespace ns3
+
+#endif // KPI_SAMPLER_H
@@ -0,0 +1,327 @@
+#include "latency-stats.h"
+
+#include "ns3/abort.h"
+#include "ns3/callback.h"
+#include "ns3/node.h"
+#include "ns3/seq-ts-header.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+namespace
+{
+
+const std::vector<std::pair<std::string, double>> g_percentiles = {
+    {"p50", 0.50},
+    {"p95", 0.95},
+    {"p99", 0.99},
+    {"p99.9", 0.999},
+};
+
+// Position of the most significant bit of a non-zero value
+uint32_t
+Msb(uint64_t value)
+{
+    return 63 - __builtin_clzll(value);
+}
+
+} // namespace
+
+double
+HistogramQuantile(const Histogram& histogram, double q)
+{
+    return HistogramQuantile(std::vector<const Histogram*>{&histogram}, q);
+}
+
+double
+HistogramQuantile(const std::vector<const Histogram*>& histograms, double q)
+{
+    // Per-bin counts of the union, the bins being aligned on zero
+    std::vector<uint64_t> counts;
+    double width = 0;
+    uint64_t total = 0;
+    for (const Histogram* histogram : histograms)
+    {
+        if (histogram->GetNBins() > counts.size())
+        {
+            counts.resize(histogram->GetNBins(), 0);
+        }
+        for (uint32_t i = 0; i < histogram->GetNBins(); ++i)
+        {
+            counts[i] += histogram->GetBinCount(i);
+            total += histogram->GetBinCount(i);
+        }
+        if (histogram->GetNBins() > 0)
+        {
+            width = histogram->GetBinWidth(0);
+        }
+    }
+    if (total == 0)
+    {
+        return 0.0;
+    }
+
+    double rank = q * total;
+    uint64_t cumulative = 0;
+    for (std::size_t i = 0; i < counts.size(); ++i)
+    {
+        if (counts[i] > 0 && cumulative + counts[i] >= rank)
+        {
+            return width * (i + (rank - cumulative) / counts[i]);
+        }
+        cumulative += counts[i];
+    }
+    return width * counts.size();
+}
+
+LatencySketch::LatencySketch(double relativeError)
+{
+    NS_ABORT_MSG_IF(relativeError <= 0 || relativeError >= 1,
+                    "The sketch relative error must be in (0, 1)");
+    m_bits = std::clamp<uint32_t>(std::ceil(std::log2(1.0 / relativeError)), 1, 20);
+}
+
+std::size_t
+LatencySketch::Index(uint64_t value) const
+{
+    if (value < (2ULL << m_bits))
+    {
+        return value;
+    }
+    uint32_t shift = Msb(value) - m_bits;
+    uint64_t mantissa = value >> shift;
+    return ((shift + 1ULL) << m_bits) + (mantissa - (1ULL << m_bits));
+}
+
+uint64_t
+LatencySketch::Lower(std::size_t index) const
+{
+    if (index < (2ULL << m_bits))
+    {
+        return index;
+    }
+    uint64_t shift = (index >> m_bits) - 1;
+    uint64_t mantissa = (index & ((1ULL << m_bits) - 1)) + (1ULL << m_bits);
+    return mantissa << shift;
+}
+
+uint64_t
+LatencySketch::Upper(std::size_t index) const
+{
+    return Lower(index + 1) - 1;
+}
+
+uint64_t&
+LatencySketch::Bucket(std::size_t index)
+{
+    if (m_counts.empty())
+    {
+        m_offset = index;
+    }
+    if (index < m_offset)
+    {
+        m_counts.insert(m_counts.begin(), m_offset - index, 0);
+        m_offset = index;
+    }
+    if (index - m_offset >= m_counts.size())
+    {
+        m_counts.resize(index - m_offset + 1, 0);
+    }
+    return m_counts[index - m_offset];
+}
+
+void
+LatencySketch::Add(Time value)
+{
+    uint64_t ns = std::max<int64_t>(value.GetNanoSeconds(), 0);
+    ++Bucket(Index(ns));
+    ++m_count;
+    m_min = std::min(m_min, ns);
+    m_max = std::max(m_max, ns);
+    m_sum += ns;
+}
+
+void
+LatencySketch::Merge(const LatencySketch& other)
+{
+    NS_ABORT_MSG_IF(other.m_bits != m_bits, "Cannot merge sketches of different precision");
+    if (other.m_counts.empty())
+    {
+        return;
+    }
+    // Grow to both ends of the other range first, then add bucket by bucket
+    Bucket(other.m_offset);
+    Bucket(other.m_offset + other.m_counts.size() - 1);
+    for (std::size_t i = 0; i < other.m_counts.size(); ++i)
+    {
+        m_counts[other.m_offset + i - m_offset] += other.m_counts[i];
+    }
+    m_count += other.m_count;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+    m_sum += other.m_sum;
+}
+
+uint64_t
+LatencySketch::GetCount() const
+{
+    return m_count;
+}
+
+Time
+LatencySketch::GetMin() const
+{
+    return NanoSeconds(m_count > 0 ? m_min : 0);
+}
+
+Time
+LatencySketch::GetMax() const
+{
+    return NanoSeconds(m_max);
+}
+
+Time
+LatencySketch::GetMean() const
+{
+    return NanoSeconds(m_count > 0 ? static_cast<int64_t>(m_sum / m_count) : 0);
+}
+
+Time
+LatencySketch::GetQuantile(double q) const
+{
+    if (m_count == 0)
+    {
+        return Seconds(0);
+    }
+    uint64_t rank = std::max<uint64_t>(1, std::ceil(q * m_count));
+    uint64_t cumulative = 0;
+    for (std::size_t i = 0; i < m_counts.size(); ++i)
+    {
+        cumulative += m_counts[i];
+        if (cumulative >= rank)
+        {
+            // Midpoint of the bucket, kept inside the observed range
+            uint64_t value = Lower(m_offset + i) + (Upper(m_offset + i) - Lower(m_offset + i)) / 2;
+            return NanoSeconds(std::clamp(value, m_min, m_max));
+        }
+    }
+    return NanoSeconds(m_max);
+}
+
+DelayProbe::DelayProbe(double relativeError)
+    : m_relativeError(relativeError)
+{
+}
+
+void
+DelayProbe::Install(const ApplicationContainer& servers)
+{
+    for (uint32_t i = 0; i < servers.GetN(); ++i)
+    {
+        Ptr<Application> server = servers.Get(i);
+        auto it = m_receivers.find(server->GetNode()->GetId());
+        if (it == m_receivers.end())
+        {
+            it = m_receivers
+                     .emplace(server->GetNode()->GetId(),
+                              Receiver{LatencySketch(m_relativeError), LatencySketch(m_relativeError)})
+                     .first;
+        }
+        server->TraceConnectWithoutContext("Rx", MakeBoundCallback(&DelayProbe::UdpRx, &it->second));
+    }
+}
+
+void
+DelayProbe::UdpRx(Receiver* receiver, Ptr<const Packet> packet)
+{
+    SeqTsHeader seqTs;
+    if (packet->GetSize() < seqTs.GetSerializedSize())
+    {
+        return;
+    }
+    packet->PeekHeader(seqTs);
+    Time delay = Simulator::Now() - seqTs.GetTs();
+    receiver->rxBytes += packet->GetSize();
+    receiver->delay.Add(delay);
+    if (receiver->hasLast)
+    {
+        receiver->jitter.Add(Abs(delay - receiver->lastDelay));
+    }
+    receiver->lastDelay = delay;
+    receiver->hasLast = true;
+}
+
+const LatencySketch*
+DelayProbe::GetDelay(uint32_t nodeId) const
+{
+    auto it = m_receivers.find(nodeId);
+    return it == m_receivers.end() || it->second.delay.GetCount() == 0 ? nullptr : &it->second.delay;
+}
+
+const LatencySketch*
+DelayProbe::GetJitter(uint32_t nodeId) const
+{
+    auto it = m_receivers.find(nodeId);
+    return it == m_receivers.end() || it->second.delay.GetCount() == 0 ? nullptr : &it->second.jitter;
+}
+
+LatencySketch
+DelayProbe::GetAggregateDelay() const
+{
+    LatencySketch aggregate(m_relativeError);
+    for (const auto& receiver : m_receivers)
+    {
+        aggregate.Merge(receiver.second.delay);
+    }
+    return aggregate;
+}
+
+LatencySketch
+DelayProbe::GetAggregateJitter() const
+{
+    LatencySketch aggregate(m_relativeError);
+    for (const auto& receiver : m_receivers)
+    {
+        aggregate.Merge(receiver.second.jitter);
+    }
+    return aggregate;
+}
+
+uint64_t
+DelayProbe::GetReceivedBytes() const
+{
+    uint64_t bytes = 0;
+    for (const auto& receiver : m_receivers)
+    {
+        bytes += receiver.second.rxBytes;
+    }
+    return bytes;
+}
+
+void
+PrintPercentiles(std::ostream& os, const std::string& label, const std::vector<const Histogram*>& histograms)
+{
+    os << label << " p50/p95/p99/p99.9: ";
+    for (std::size_t i = 0; i < g_percentiles.size(); ++i)
+    {
+        os << (i > 0 ? " / " : "") << 1000 * HistogramQuantile(histograms, g_percentiles[i].second);
+    }
+    os << " ms\n";
+}
+
+void
+PrintPercentiles(std::ostream& os, const std::string& label, const LatencySketch& sketch)
+{
+    os << label << " p50/p95/p99/p99.9: ";
+    for (std::size_t i = 0; i < g_percentiles.size(); ++i)
+    {
+        os << (i > 0 ? " / " : "") << sketch.GetQuantile(g_percentiles[i].second).GetSeconds() * 1000;
+    }
+    os << " ms\n";
+}
+
+} // namespace ns3
@@ -0,0 +1,118 @@
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include "ns3/application-container.h"
+#include "ns3/histogram.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Quantile q (0..1) of a FlowMonitor histogram, interpolating linearly
+ * inside the bin that holds the target rank. Returns 0 for empty histograms.
+ */
+double HistogramQuantile(const Histogram& histogram, double q);
+
+/// Quantile of the union of several histograms sharing the same bin width
+double HistogramQuantile(const std::vector<const Histogram*>& histograms, double q);
+
+/**
+ * Log-linear latency sketch in the spirit of HdrHistogram.
+ *
+ * Values (in nanoseconds) are exact up to 2^(bits+1) and beyond that are kept
+ * in buckets whose width is at most `relativeError` of their value, so
+ * quantiles have a bounded relative error whatever the delay range is, with
+ * O(1) insertion. Buckets are only stored from the smallest to the largest
+ * index seen, so memory follows the spread of the values rather than their
+ * magnitude.
+ */
+class LatencySketch
+{
+  public:
+    explicit LatencySketch(double relativeError = 0.01);
+
+    void Add(Time value);
+    void Merge(const LatencySketch& other);
+
+    uint64_t GetCount() const;
+    Time GetMin() const;
+    Time GetMax() const;
+    Time GetMean() const;
+    /// Value below which a fraction q of the samples fall
+    Time GetQuantile(double q) const;
+
+  private:
+    std::size_t Index(uint64_t value) const;
+    uint64_t Lower(std::size_t index) const;
+    uint64_t Upper(std::size_t index) const;
+    /// Counter of a bucket, growing the stored range to include it
+    uint64_t& Bucket(std::size_t index);
+
+    uint32_t m_bits;
+    std::size_t m_offset{0}; // Index of m_counts[0]
+    std::vector<uint64_t> m_counts;
+    uint64_t m_count{0};
+    uint64_t m_min{UINT64_MAX};
+    uint64_t m_max{0};
+    double m_sum{0};
+};
+
+/**
+ * Per-packet delay and jitter of the UdpClient -> UdpServer traffic.
+ *
+ * Hooks the Rx trace of every UdpServer (and UrllcSink), reads the send time stamped by the
+ * client in the SeqTsHeader and feeds per-receiver sketches of the one-way
+ * delay and of the delay variation between consecutive packets (IPDV).
+ * Unlike the FlowMonitor histograms its resolution does not depend on a
+ * bin width. Each server is bound to its own receiver, so a packet costs no
+ * lookup.
+ */
+class DelayProbe
+{
+  public:
+    explicit DelayProbe(double relativeError);
+
+    /// Connect to the Rx trace of these UdpServer and UrllcSink applications
+    void Install(const ApplicationContainer& servers);
+
+    /// Sketches of the packets received by a node; nullptr if none were received
+    const LatencySketch* GetDelay(uint32_t nodeId) const;
+    const LatencySketch* GetJitter(uint32_t nodeId) const;
+    /// Sketches over all the receivers
+    LatencySketch GetAggregateDelay() const;
+    LatencySketch GetAggregateJitter() const;
+    /// Bytes received by all the UDP servers, UDP payload
+    uint64_t GetReceivedBytes() const;
+
+  private:
+    struct Receiver
+    {
+        LatencySketch delay;
+        LatencySketch jitter;
+        Time lastDelay;
+        bool hasLast{false};
+        uint64_t rxBytes{0};
+    };
+
+    static void UdpRx(Receiver* receiver, Ptr<const Packet> packet);
+
+    double m_relativeError;
+    std::map<uint32_t, Receiver> m_receivers; // By node id
+};
+
+/// Print "label p50/p95/p99/p99.9: a / b / c / d ms"
+void PrintPercentiles(std::ostream& os, const std::string& label, const std::vector<const Histogram*>& histograms);
+void PrintPercentiles(std::ostream& os, const std::string& label, const LatencySketch& sketch);
+
+} // namespace ns3
+
+#endif // LATENCY_STATS_H
@@ -0,0 +1,269 @@
+#include "link-quality-probe.h"
+
+#include "ns3/abort.h"
+#include "ns3/callback.h"
+#include "ns3/lte-ue-rrc.h"
+#include "ns3/nr-control-messages.h"
+#include "ns3/nr-gnb-mac.h"
+#include "ns3/nr-gnb-net-device.h"
+#include "ns3/nr-gnb-phy.h"
+#include "ns3/nr-helper.h"
+#include "ns3/nr-ue-net-device.h"
+#include "ns3/nr-ue-phy.h"
+#include "ns3/sfnsf.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+namespace
+{
+
+/// Value index at which a histogram reaches the quantile q
+template <std::size_t N>
+uint32_t
+Quantile(const std::array<uint64_t, N>& histogram, double q)
+{
+    uint64_t total = 0;
+    for (uint64_t count : histogram)
+    {
+        total += count;
+    }
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < N; ++i)
+    {
+        seen += histogram[i];
+        if (seen > 0 && seen >= q * total)
+        {
+            return i;
+        }
+    }
+    return 0;
+}
+
+template <std::size_t N>
+double
+Mean(const std::array<uint64_t, N>& histogram)
+{
+    uint64_t total = 0;
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < N; ++i)
+    {
+        total += histogram[i];
+        sum += i * histogram[i];
+    }
+    return total > 0 ? static_cast<double>(sum) / total : 0.0;
+}
+
+template <std::size_t N>
+void
+Add(std::array<uint64_t, N>& to, const std::array<uint64_t, N>& from)
+{
+    for (uint32_t i = 0; i < N; ++i)
+    {
+        to[i] += from[i];
+    }
+}
+
+} // namespace
+
+void
+LinkQualityProbe::Histograms::Merge(const Histograms& other)
+{
+    Add(sinr, other.sinr);
+    sinrSumDb += other.sinrSumDb;
+    sinrSamples += other.sinrSamples;
+    Add(wbCqi, other.wbCqi);
+    Add(sbCqi, other.sbCqi);
+    Add(mcs, other.mcs);
+}
+
+LinkQualityProbe::LinkQualityProbe()
+{
+}
+
+LinkQualityProbe::~LinkQualityProbe()
+{
+}
+
+void
+LinkQualityProbe::Install(const NetDeviceContainer& ueDevices, const NetDeviceContainer& gnbDevices)
+{
+    for (uint32_t i = 0; i < ueDevices.GetN(); ++i)
+    {
+        Ptr<NrUeNetDevice> device = DynamicCast<NrUeNetDevice>(ueDevices.Get(i));
+        NS_ABORT_MSG_IF(!device, "The link quality probe needs UE devices");
+        auto ue = std::make_unique<Ue>();
+        ue->probe = this;
+        ue->nodeId = device->GetNode()->GetId();
+        for (uint32_t bwp = 0; bwp < device->GetCcMapSize(); ++bwp)
+        {
+            auto entry = std::make_unique<Bwp>();
+            entry->ue = ue.get();
+            entry->phy = NrHelper::GetUePhy(device, bwp);
+            entry->phy->TraceConnectWithoutContext("DlDataSinr",
+                                                   MakeBoundCallback(&LinkQualityProbe::DlDataSinr, entry.get()));
+            entry->phy->TraceConnectWithoutContext("UePhyTxedCtrlMsgsTrace",
+                                                   MakeBoundCallback(&LinkQualityProbe::TxedCtrlMsg, ue.get()));
+            ue->bwps.push_back(std::move(entry));
+        }
+        device->GetRrc()->TraceConnectWithoutContext("ConnectionEstablished",
+                                                     MakeBoundCallback(&LinkQualityProbe::Connected, ue.get()));
+        device->GetRrc()->TraceConnectWithoutContext("HandoverEndOk",
+                                                     MakeBoundCallback(&LinkQualityProbe::Connected, ue.get()));
+        m_ues[ue->nodeId] = std::move(ue);
+    }
+
+    for (uint32_t i = 0; i < gnbDevices.GetN(); ++i)
+    {
+        Ptr<NrGnbNetDevice> gnb = DynamicCast<NrGnbNetDevice>(gnbDevices.Get(i));
+        NS_ABORT_MSG_IF(!gnb, "The link quality probe needs gNB devices");
+        for (uint32_t bwp = 0; bwp < gnb->GetCcMapSize(); ++bwp)
+        {
+            auto cell = std::make_unique<Cell>();
+            cell->probe = this;
+            cell->cellId = NrHelper::GetGnbPhy(gnb, bwp)->GetCellId();
+            NrHelper::GetGnbMac(gnb, bwp)->TraceConnectWithoutContext(
+                "DlScheduling",
+                MakeBoundCallback(&LinkQualityProbe::DlScheduling, cell.get()));
+            m_cells.push_back(std::move(cell));
+        }
+    }
+}
+
+void
+LinkQualityProbe::Connected(Ue* ue, uint64_t, uint16_t, uint16_t rnti)
+{
+    // The RRC gives the cell of the primary BWP only
+    for (const auto& bwp : ue->bwps)
+    {
+        Register(bwp.get(), bwp->phy->GetCellId(), rnti);
+    }
+}
+
+void
+LinkQualityProbe::Register(Bwp* bwp, uint16_t cellId, uint16_t rnti)
+{
+    if (bwp->cellId == cellId && bwp->rnti == rnti)
+    {
+        return;
+    }
+    auto& byRnti = bwp->ue->probe->m_byRnti;
+    auto old = byRnti.find(static_cast<uint32_t>(bwp->cellId) << 16 | bwp->rnti);
+    if (old != byRnti.end() && old->second == bwp->ue)
+    {
+        byRnti.erase(old);
+    }
+    byRnti[static_cast<uint32_t>(cellId) << 16 | rnti] = bwp->ue;
+    bwp->cellId = cellId;
+    bwp->rnti = rnti;
+}
+
+void
+LinkQualityProbe::DlDataSinr(Bwp* bwp, uint16_t cellId, uint16_t rnti, double sinr, uint16_t)
+{
+    Register(bwp, cellId, rnti);
+
+    Histograms& histograms = bwp->ue->histograms;
+    double sinrDb = 10 * std::log10(std::max(sinr, 1e-12));
+    int32_t bin = static_cast<int32_t>(std::floor(sinrDb)) - SINR_MIN_DB;
+    ++histograms.sinr[std::clamp<int32_t>(bin, 0, SINR_BINS - 1)];
+    histograms.sinrSumDb += sinrDb;
+    ++histograms.sinrSamples;
+}
+
+void
+LinkQualityProbe::TxedCtrlMsg(Ue* ue, SfnSf, uint16_t, uint16_t, uint8_t, Ptr<const NrControlMessage> msg)
+{
+    if (msg->GetMessageType() != NrControlMessage::DL_CQI)
+    {
+        return;
+    }
+    DlCqiInfo cqi = DynamicCast<NrDlCqiMessage>(ConstCast<NrControlMessage>(msg))->GetDlCqi();
+    Histograms& histograms = ue->histograms;
+    ++histograms.wbCqi[std::min<uint32_t>(cqi.m_wbCqi, CQI_VALUES - 1)];
+    for (uint8_t subband : cqi.m_sbCqi)
+    {
+        ++histograms.sbCqi[std::min<uint32_t>(subband, CQI_VALUES - 1)];
+    }
+}
+
+void
+LinkQualityProbe::DlScheduling(Cell* cell, NrSchedulingCallbackInfo info)
+{
+    auto it = cell->probe->m_byRnti.find(static_cast<uint32_t>(cell->cellId) << 16 | info.m_rnti);
+    if (it != cell->probe->m_byRnti.end())
+    {
+        ++it->second->histograms.mcs[std::min<uint32_t>(info.m_mcs, MCS_VALUES - 1)];
+    }
+}
+
+int32_t
+LinkQualityProbe::SinrQuantile(const Histograms& histograms, double q)
+{
+    // Lower edge of the 1 dB bin
+    return static_cast<int32_t>(Quantile(histograms.sinr, q)) + SINR_MIN_DB;
+}
+
+void
+LinkQualityProbe::Print(std::ostream& os, const std::string& prefix, const Histograms& histograms)
+{
+    if (histograms.sinrSamples > 0)
+    {
+        os << prefix << "SINR p5/p50/p95: " << SinrQuantile(histograms, 0.05) << " / "
+           << SinrQuantile(histograms, 0.5) << " / " << SinrQuantile(histograms, 0.95) << " dB, mean "
+           << histograms.sinrSumDb / histograms.sinrSamples << " dB\n";
+    }
+    os << prefix << "CQI p5/p50/p95: wideband " << Quantile(histograms.wbCqi, 0.05) << " / "
+       << Quantile(histograms.wbCqi, 0.5) << " / " << Quantile(histograms.wbCqi, 0.95) << " (mean "
+       << Mean(histograms.wbCqi) << "), subband " << Quantile(histograms.sbCqi, 0.05) << " / "
+       << Quantile(histograms.sbCqi, 0.5) << " / " << Quantile(histograms.sbCqi, 0.95) << "\n";
+    os << prefix << "MCS p5/p50/p95: " << Quantile(histograms.mcs, 0.05) << " / " << Quantile(histograms.mcs, 0.5)
+       << " / " << Quantile(histograms.mcs, 0.95) << " (mean " << Mean(histograms.mcs) << ")\n";
+}
+
+void
+LinkQualityProbe::PrintUe(std::ostream& os, uint32_t nodeId) const
+{
+    auto it = m_ues.find(nodeId);
+    if (it != m_ues.end())
+    {
+        Print(os, "  ", it->second->histograms);
+    }
+}
+
+void
+LinkQualityProbe::Report(std::ostream& os) const
+{
+    Histograms all;
+    uint32_t lowSinr = 0;
+    for (const auto& ue : m_ues)
+    {
+        const Histograms& histograms = ue.second->histograms;
+        all.Merge(histograms);
+        if (histograms.sinrSamples > 0 && SinrQuantile(histograms, 0.5) < 0)
+        {
+            ++lowSinr;
+        }
+    }
+    Print(os, "  All UEs ", all);
+    os << "  Mean SINR: " << GetMeanSinrDb() << " dB\n";
+    os << "  UEs with median SINR below 0 dB: " << lowSinr << " of " << m_ues.size() << "\n";
+}
+
+double
+LinkQualityProbe::GetMeanSinrDb() const
+{
+    double sum = 0;
+    uint64_t samples = 0;
+    for (const auto& ue : m_ues)
+    {
+        sum += ue.second->histograms.sinrSumDb;
+        samples += ue.second->histograms.sinrSamples;
+    }
+    return samples > 0 ? sum / samples : std::nan("");
+}
+
+} // namespace ns3
@@ -0,0 +1,121 @@
+#ifndef LINK_QUALITY_PROBE_H
+#define LINK_QUALITY_PROBE_H
+
+#include "ns3/net-device-container.h"
+#include "ns3/ptr.h"
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+class NrControlMessage;
+class NrUePhy;
+class SfnSf;
+struct NrSchedulingCallbackInfo;
+
+/**
+ * Downlink link quality seen by every UE, as streaming histograms.
+ *
+ * - SINR of the data TBs received by the UE PHY (DlDataSinr), in 1 dB bins
+ *   from -20 to 50 dB
+ * - wideband and subband CQI of the DL CQI reports the UE PHY sends
+ * - MCS of the TBs the gNB MAC schedules to the UE (DlScheduling)
+ *
+ * The memory per UE is fixed, whatever the run length. Every BWP has its
+ * own cell ID, so the UE is registered once per BWP under the cell ID and
+ * RNTI of that BWP's PHY, read when the RRC connection is established or
+ * handed over and corrected by the SINR samples of the BWP; the MCS of a
+ * gNB MAC is matched to the UE through its own cell ID and the RNTI.
+ */
+class LinkQualityProbe
+{
+  public:
+    LinkQualityProbe();
+    ~LinkQualityProbe();
+
+    /// Connect to the PHY of every BWP of the UEs and to the MAC of every BWP of the gNBs
+    void Install(const NetDeviceContainer& ueDevices, const NetDeviceContainer& gnbDevices);
+
+    /// Print the SINR, CQI and MCS percentiles of the UE on a node, if it has any
+    void PrintUe(std::ostream& os, uint32_t nodeId) const;
+    /// Percentiles over all the UEs, and how many have a median SINR below 0 dB
+    void Report(std::ostream& os) const;
+
+    /// Mean of the SINR samples of all the UEs, in dB
+    double GetMeanSinrDb() const;
+
+  private:
+    static constexpr int32_t SINR_MIN_DB = -20;
+    static constexpr uint32_t SINR_BINS = 71;
+    static constexpr uint32_t CQI_VALUES = 16;
+    static constexpr uint32_t MCS_VALUES = 32;
+
+    struct Histograms
+    {
+        std::array<uint64_t, SINR_BINS> sinr{};
+        double sinrSumDb{0};
+        uint64_t sinrSamples{0};
+        std::array<uint64_t, CQI_VALUES> wbCqi{};
+        std::array<uint64_t, CQI_VALUES> sbCqi{};
+        std::array<uint64_t, MCS_VALUES> mcs{};
+
+        void Merge(const Histograms& other);
+    };
+
+    struct Ue;
+
+    /// One BWP of a UE, registered under its (cell ID, RNTI)
+    struct Bwp
+    {
+        Ue* ue{nullptr};
+        Ptr<NrUePhy> phy;
+        uint16_t cellId{0};
+        uint16_t rnti{0};
+    };
+
+    struct Ue
+    {
+        LinkQualityProbe* probe{nullptr};
+        uint32_t nodeId{0};
+        std::vector<std::unique_ptr<Bwp>> bwps;
+        Histograms histograms;
+    };
+
+    struct Cell
+    {
+        LinkQualityProbe* probe{nullptr};
+        uint16_t cellId{0};
+    };
+
+    /// Register every BWP of the UE with the cell ID and RNTI of its PHY
+    static void Connected(Ue* ue, uint64_t imsi, uint16_t cellId, uint16_t rnti);
+    static void Register(Bwp* bwp, uint16_t cellId, uint16_t rnti);
+    static void DlDataSinr(Bwp* bwp, uint16_t cellId, uint16_t rnti, double sinr, uint16_t bwpId);
+    static void TxedCtrlMsg(Ue* ue,
+                            SfnSf sfnSf,
+                            uint16_t nodeId,
+                            uint16_t rnti,
+                            uint8_t bwpId,
+                            Ptr<const NrControlMessage> msg);
+    static void DlScheduling(Cell* cell, NrSchedulingCallbackInfo info);
+
+    static int32_t SinrQuantile(const Histograms& histograms, double q);
+    static void Print(std::ostream& os, const std::string& prefix, const Histograms& histograms);
+
+    std::map<uint32_t, std::unique_ptr<Ue>> m_ues;
+    std::vector<std::unique_ptr<Cell>> m_cells;
+    // (cellId << 16 | RNTI) of every BWP of the UEs
+    std::unordered_map<uint32_t, Ue*> m_byRnti;
+};
+
+} // namespace ns3
+
+#endif // LINK_QUALITY_PROBE_H
@@ -0,0 +1,265 @@
+#include "mac-slot-stats.h"
+
+#include "columnar-writer.h"
+
+#include "ns3/abort.h"
+#include "ns3/callback.h"
+#include "ns3/nr-gnb-mac.h"
+#include "ns3/nr-gnb-net-device.h"
+#include "ns3/nr-gnb-phy.h"
+#include "ns3/nr-helper.h"
+#include "ns3/sfnsf.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace ns3
+{
+
+MacSlotStats::MacSlotStats(uint32_t slots)
+    : m_capacity(slots)
+{
+    NS_ABORT_MSG_IF(slots == 0, "The MAC slot ring buffer needs at least one slot");
+}
+
+MacSlotStats::~MacSlotStats()
+{
+}
+
+void
+MacSlotStats::Install(const NetDeviceContainer& gnbDevices)
+{
+    for (uint32_t i = 0; i < gnbDevices.GetN(); ++i)
+    {
+        Ptr<NrGnbNetDevice> gnb = DynamicCast<NrGnbNetDevice>(gnbDevices.Get(i));
+        NS_ABORT_MSG_IF(!gnb, "The MAC slot statistics need gNB devices");
+        for (uint32_t bwp = 0; bwp < gnb->GetCcMapSize(); ++bwp)
+        {
+            auto carrier = std::make_unique<Carrier>();
+            carrier->cellId = gnb->GetCellId();
+            carrier->bwpId = bwp;
+            carrier->capacity = m_capacity;
+            carrier->ring.reserve(m_capacity);
+            NrHelper::GetGnbPhy(gnb, bwp)->TraceConnectWithoutContext(
+                "SlotDataStats",
+                MakeBoundCallback(&MacSlotStats::SlotDataStats, carrier.get()));
+            NrHelper::GetGnbMac(gnb, bwp)->TraceConnectWithoutContext(
+                "DlScheduling",
+                MakeBoundCallback(&MacSlotStats::DlScheduling, carrier.get()));
+            m_carriers.push_back(std::move(carrier));
+        }
+    }
+}
+
+uint32_t
+MacSlotStats::UtilizationBin(double ratio)
+{
+    return std::min<uint32_t>(UTILIZATION_BINS - 1, static_cast<uint32_t>(ratio * (UTILIZATION_BINS - 1)));
+}
+
+template <std::size_t N>
+uint32_t
+MacSlotStats::BinQuantile(const std::array<uint64_t, N>& histogram, double q)
+{
+    uint64_t total = 0;
+    for (uint64_t count : histogram)
+    {
+        total += count;
+    }
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < N; ++i)
+    {
+        seen += histogram[i];
+        if (seen > 0 && seen >= q * total)
+        {
+            return i;
+        }
+    }
+    return 0;
+}
+
+void
+MacSlotStats::SlotDataStats(Carrier* carrier,
+                            const SfnSf& sfnSf,
+                            uint32_t scheduledUe,
+                            uint32_t usedReg,
+                            uint32_t usedSym,
+                            uint32_t availableRb,
+                            uint32_t availableSym,
+                            uint16_t bwpId,
+                            uint16_t cellId)
+{
+    Slot slot{Simulator::Now(),
+              sfnSf.GetFrame(),
+              sfnSf.GetSubframe(),
+              sfnSf.GetSlot(),
+              static_cast<uint16_t>(scheduledUe),
+              usedReg,
+              usedSym,
+              availableRb,
+              availableSym};
+    if (carrier->ring.size() < carrier->capacity)
+    {
+        carrier->ring.push_back(slot);
+    }
+    else
+    {
+        carrier->ring[carrier->slots % carrier->capacity] = slot;
+    }
+
+    // The PHY knows the cell ID of each BWP
+    carrier->cellId = cellId;
+    carrier->bwpId = bwpId;
+    ++carrier->slots;
+    carrier->dataSlots += scheduledUe > 0;
+    carrier->usedReg += usedReg;
+    carrier->availableReg += static_cast<uint64_t>(availableRb) * availableSym;
+    carrier->usedSym += usedSym;
+    carrier->availableSym += availableSym;
+    if (availableRb > 0 && availableSym > 0)
+    {
+        ++carrier->rbUtilization[UtilizationBin(static_cast<double>(usedReg) / availableRb / availableSym)];
+        ++carrier->symUtilization[UtilizationBin(static_cast<double>(usedSym) / availableSym)];
+    }
+    if (scheduledUe >= carrier->uesPerSlot.size())
+    {
+        carrier->uesPerSlot.resize(scheduledUe + 1);
+    }
+    ++carrier->uesPerSlot[scheduledUe];
+}
+
+void
+MacSlotStats::DlScheduling(Carrier* carrier, NrSchedulingCallbackInfo info)
+{
+    ++carrier->mcs[std::min<uint32_t>(info.m_mcs, MCS_VALUES - 1)];
+    ++carrier->transportBlocks;
+    carrier->tbBytes += info.m_tbSize;
+}
+
+void
+MacSlotStats::Export(const std::string& slotsPath, const std::string& histogramsPath) const
+{
+    ColumnarWriter slots(slotsPath,
+                         ColumnarWriter::Columns{
+                             {"time", ColumnarWriter::DOUBLE},
+                             {"cellId", ColumnarWriter::UINT32},
+                             {"bwpId", ColumnarWriter::UINT32},
+                             {"frame", ColumnarWriter::UINT32},
+                             {"subframe", ColumnarWriter::UINT32},
+                             {"slot", ColumnarWriter::UINT32},
+                             {"scheduledUes", ColumnarWriter::UINT32},
+                             {"usedReg", ColumnarWriter::UINT32},
+                             {"usedSym", ColumnarWriter::UINT32},
+                             {"availableRb", ColumnarWriter::UINT32},
+                             {"availableSym", ColumnarWriter::UINT32},
+                         });
+    std::ofstream histograms(histogramsPath);
+    histograms << "cellId,bwpId,histogram,bin,count\n";
+    for (const auto& carrier : m_carriers)
+    {
+        // Oldest slot first once the ring has wrapped around
+        std::size_t size = carrier->ring.size();
+        std::size_t first = carrier->slots > size ? carrier->slots % size : 0;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            const Slot& slot = carrier->ring[(first + i) % size];
+            slots.AppendDouble(slot.time.GetSeconds());
+            slots.AppendUint32(carrier->cellId);
+            slots.AppendUint32(carrier->bwpId);
+            slots.AppendUint32(slot.frame);
+            slots.AppendUint32(slot.subframe);
+            slots.AppendUint32(slot.slot);
+            slots.AppendUint32(slot.ues);
+            slots.AppendUint32(slot.usedReg);
+            slots.AppendUint32(slot.usedSym);
+            slots.AppendUint32(slot.availableRb);
+            slots.AppendUint32(slot.availableSym);
+            slots.EndRow();
+        }
+
+        // Utilization bins are labelled with their lower bound in percent
+        std::string prefix = std::to_string(carrier->cellId) + "," + std::to_string(carrier->bwpId) + ",";
+        for (uint32_t bin = 0; bin < UTILIZATION_BINS; ++bin)
+        {
+            uint32_t percent = bin * 100 / (UTILIZATION_BINS - 1);
+            histograms << prefix << "rbUtilization," << percent << "," << carrier->rbUtilization[bin] << "\n";
+            histograms << prefix << "symUtilization," << percent << "," << carrier->symUtilization[bin] << "\n";
+        }
+        for (std::size_t ues = 0; ues < carrier->uesPerSlot.size(); ++ues)
+        {
+            histograms << prefix << "uesPerSlot," << ues << "," << carrier->uesPerSlot[ues] << "\n";
+        }
+        for (uint32_t mcs = 0; mcs < MCS_VALUES; ++mcs)
+        {
+            histograms << prefix << "mcs," << mcs << "," << carrier->mcs[mcs] << "\n";
+        }
+    }
+    slots.Close();
+}
+
+double
+MacSlotStats::GetRbUtilization() const
+{
+    uint64_t usedReg = 0;
+    uint64_t availableReg = 0;
+    for (const auto& carrier : m_carriers)
+    {
+        usedReg += carrier->usedReg;
+        availableReg += carrier->availableReg;
+    }
+    return availableReg > 0 ? 100.0 * usedReg / availableReg : 0.0;
+}
+
+double
+MacSlotStats::GetMeanMcs() const
+{
+    uint64_t transportBlocks = 0;
+    uint64_t mcsSum = 0;
+    for (const auto& carrier : m_carriers)
+    {
+        for (uint32_t mcs = 0; mcs < MCS_VALUES; ++mcs)
+        {
+            mcsSum += mcs * carrier->mcs[mcs];
+        }
+        transportBlocks += carrier->transportBlocks;
+    }
+    return transportBlocks > 0 ? static_cast<double>(mcsSum) / transportBlocks : 0.0;
+}
+
+void
+MacSlotStats::Report(std::ostream& os) const
+{
+    for (const auto& carrier : m_carriers)
+    {
+        uint64_t ueSum = 0;
+        for (std::size_t ues = 0; ues < carrier->uesPerSlot.size(); ++ues)
+        {
+            ueSum += ues * carrier->uesPerSlot[ues];
+        }
+        uint64_t carrierMcsSum = 0;
+        for (uint32_t mcs = 0; mcs < MCS_VALUES; ++mcs)
+        {
+            carrierMcsSum += mcs * carrier->mcs[mcs];
+        }
+        uint32_t binWidth = 100 / (UTILIZATION_BINS - 1);
+
+        os << "  MAC cell " << carrier->cellId << " BWP " << carrier->bwpId << ": " << carrier->slots << " slots, "
+           << (carrier->slots > 0 ? 100.0 * carrier->dataSlots / carrier->slots : 0.0) << " % with data, RB use "
+           << (carrier->availableReg > 0 ? 100.0 * carrier->usedReg / carrier->availableReg : 0.0) << " % (p50/p95 "
+           << BinQuantile(carrier->rbUtilization, 0.5) * binWidth << " / "
+           << BinQuantile(carrier->rbUtilization, 0.95) * binWidth << " %), symbols "
+           << (carrier->availableSym > 0 ? 100.0 * carrier->usedSym / carrier->availableSym : 0.0)
+           << " %, UEs per slot mean " << (carrier->slots > 0 ? static_cast<double>(ueSum) / carrier->slots : 0.0)
+           << " max " << (carrier->uesPerSlot.empty() ? 0 : carrier->uesPerSlot.size() - 1) << "\n";
+        os << "  MAC cell " << carrier->cellId << " BWP " << carrier->bwpId << " MCS mean "
+           << (carrier->transportBlocks > 0 ? static_cast<double>(carrierMcsSum) / carrier->transportBlocks : 0.0)
+           << " (p10/p50/p90 " << BinQuantile(carrier->mcs, 0.1) << " / " << BinQuantile(carrier->mcs, 0.5) << " / "
+           << BinQuantile(carrier->mcs, 0.9) << "), " << carrier->transportBlocks << " TBs, "
+           << carrier->tbBytes / 1e6 << " MB\n";
+    }
+    os << "  MAC RB utilization: " << GetRbUtilization() << " %\n";
+    os << "  MAC mean MCS: " << GetMeanMcs() << "\n";
+}
+
+} // namespace ns3
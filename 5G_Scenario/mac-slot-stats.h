@@ -0,0 +1,118 @@
+#ifndef MAC_SLOT_STATS_H
+#define MAC_SLOT_STATS_H
+
+#include "ns3/net-device-container.h"
+#include "ns3/nstime.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class SfnSf;
+struct NrSchedulingCallbackInfo;
+
+/**
+ * Per slot view of the downlink scheduling of every gNB carrier (cell and
+ * BWP), kept in memory in place of the NrHelper::EnableTraces text files.
+ *
+ * The PHY SlotDataStats trace gives, for every slot, the scheduled UEs and
+ * the used and available RBs and symbols; the MAC DlScheduling trace gives
+ * the MCS and size of every transport block. Each carrier keeps:
+ * - the last `slots` slots in a fixed size ring buffer (time, SFN, UEs,
+ *   used REGs and symbols, available RBs and symbols)
+ * - histograms over the whole run of the RB and symbol utilization (5 %
+ *   bins), of the UEs per slot and of the MCS of the transport blocks
+ * so the memory does not depend on the run length. Nothing is written
+ * before Export() at the end of the run.
+ */
+class MacSlotStats
+{
+  public:
+    /// Keep the last `slots` slots of each carrier
+    explicit MacSlotStats(uint32_t slots);
+    ~MacSlotStats();
+
+    /// Connect to the PHY and MAC of every BWP of these gNBs
+    void Install(const NetDeviceContainer& gnbDevices);
+
+    /// Write the ring buffers to a columnar file and the histograms to a CSV file
+    void Export(const std::string& slotsPath, const std::string& histogramsPath) const;
+
+    /// Share of the REGs of all the carriers used for data, in percent
+    double GetRbUtilization() const;
+    /// Mean MCS of the transport blocks of all the carriers
+    double GetMeanMcs() const;
+
+    /// Summary per carrier and over all of them
+    void Report(std::ostream& os) const;
+
+  private:
+    // 5 % bins from 0 to 100 %
+    static constexpr uint32_t UTILIZATION_BINS = 21;
+    static constexpr uint32_t MCS_VALUES = 32;
+
+    struct Slot
+    {
+        Time time;
+        uint32_t frame;
+        uint8_t subframe;
+        uint16_t slot;
+        uint16_t ues;
+        uint32_t usedReg;
+        uint32_t usedSym;
+        uint32_t availableRb;
+        uint32_t availableSym;
+    };
+
+    struct Carrier
+    {
+        uint16_t cellId{0};
+        uint16_t bwpId{0};
+
+        std::vector<Slot> ring;
+        uint32_t capacity{0};
+        uint64_t slots{0};
+        uint64_t dataSlots{0};
+        uint64_t usedReg{0};
+        uint64_t availableReg{0};
+        uint64_t usedSym{0};
+        uint64_t availableSym{0};
+
+        std::array<uint64_t, UTILIZATION_BINS> rbUtilization{};
+        std::array<uint64_t, UTILIZATION_BINS> symUtilization{};
+        std::vector<uint64_t> uesPerSlot;
+        std::array<uint64_t, MCS_VALUES> mcs{};
+        uint64_t transportBlocks{0};
+        uint64_t tbBytes{0};
+    };
+
+    static void SlotDataStats(Carrier* carrier,
+                              const SfnSf& sfnSf,
+                              uint32_t scheduledUe,
+                              uint32_t usedReg,
+                              uint32_t usedSym,
+                              uint32_t availableRb,
+                              uint32_t availableSym,
+                              uint16_t bwpId,
+                              uint16_t cellId);
+    static void DlScheduling(Carrier* carrier, NrSchedulingCallbackInfo info);
+
+    /// Bin of a utilization ratio in [0, 1]
+    static uint32_t UtilizationBin(double ratio);
+    /// Quantile of a histogram of equal width bins, as a bin index
+    template <std::size_t N>
+    static uint32_t BinQuantile(const std::array<uint64_t, N>& histogram, double q);
+
+    uint32_t m_capacity;
+    std::vector<std::unique_ptr<Carrier>> m_carriers;
+};
+
+} // namespace ns3
+
+#endif // MAC_SLOT_STATS_H
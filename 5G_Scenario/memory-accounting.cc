@@ -0,0 +1,350 @@
+#include "memory-accounting.h"
+
+#include "animation-trace-sink.h"
+#include "cached-channel-model.h"
+#include "rlc-queue-manager.h"
+
+#include "ns3/abort.h"
+#include "ns3/channel-list.h"
+#include "ns3/node-list.h"
+#include "ns3/object-ptr-container.h"
+#include "ns3/pointer.h"
+#include "ns3/queue.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <unistd.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace ns3
+{
+
+namespace
+{
+
+// Red-black tree node overhead of a std::map entry
+const uint64_t g_mapNodeBytes = 32;
+
+/// Counts the objects reachable from the nodes and channels through the attribute system
+class ObjectWalker
+{
+  public:
+    explicit ObjectWalker(MemoryAccounting::Snapshot& snapshot)
+        : m_snapshot(snapshot)
+    {
+    }
+
+    void Visit(Ptr<Object> object)
+    {
+        if (!object || !m_seen.insert(PeekPointer(object)).second)
+        {
+            return;
+        }
+        TypeId tid = object->GetInstanceTypeId();
+        ++m_snapshot.objects;
+        ++m_snapshot.objectsByType[tid.GetName()];
+        if (Ptr<QueueBase> queue = DynamicCast<QueueBase>(object))
+        {
+            m_snapshot.queuedPackets += queue->GetNPackets();
+            m_snapshot.queuedBytes += queue->GetNBytes();
+        }
+
+        Object::AggregateIterator aggregates = object->GetAggregateIterator();
+        while (aggregates.HasNext())
+        {
+            Visit(ConstCast<Object>(aggregates.Next()));
+        }
+
+        // The attributes of the TypeId and of all its parents
+        for (TypeId t = tid;; t = t.GetParent())
+        {
+            for (std::size_t i = 0; i < t.GetAttributeN(); ++i)
+            {
+                VisitAttribute(object, t.GetAttribute(i));
+            }
+            if (t == t.GetParent())
+            {
+                break;
+            }
+        }
+    }
+
+  private:
+    void VisitAttribute(Ptr<Object> object, const TypeId::AttributeInformation& info)
+    {
+        if (!(info.flags & TypeId::ATTR_GET) || !info.accessor->HasGetter())
+        {
+            return;
+        }
+        if (dynamic_cast<const PointerChecker*>(PeekPointer(info.checker)))
+        {
+            PointerValue value;
+            if (object->GetAttributeFailSafe(info.name, value))
+            {
+                Visit(value.Get<Object>());
+            }
+        }
+        else if (dynamic_cast<const ObjectPtrContainerChecker*>(PeekPointer(info.checker)))
+        {
+            ObjectPtrContainerValue value;
+            if (object->GetAttributeFailSafe(info.name, value))
+            {
+                for (auto it = value.Begin(); it != value.End(); ++it)
+                {
+                    Visit(it->second);
+                }
+            }
+        }
+    }
+
+    MemoryAccounting::Snapshot& m_snapshot;
+    std::set<const Object*> m_seen;
+};
+
+/// Heap bytes of the dropped packet counters and histograms of one flow
+uint64_t
+FlowStatsBytes(const FlowMonitor::FlowStats& stats)
+{
+    return (stats.delayHistogram.GetNBins() + stats.jitterHistogram.GetNBins() +
+            stats.packetSizeHistogram.GetNBins() + stats.flowInterruptionsHistogram.GetNBins() +
+            stats.packetsDropped.capacity()) *
+               sizeof(uint32_t) +
+           stats.bytesDropped.capacity() * sizeof(uint64_t);
+}
+
+} // namespace
+
+MemoryAccounting::MemoryAccounting(Ptr<FlowMonitor> monitor)
+    : m_monitor(monitor)
+{
+}
+
+void
+MemoryAccounting::SetAnimationSink(const AnimationTraceSink* sink)
+{
+    m_animationSink = sink;
+}
+
+void
+MemoryAccounting::SetRlcQueues(const RlcQueueManager* queues)
+{
+    m_rlcQueues = queues;
+}
+
+void
+MemoryAccounting::AddChannelCache(Ptr<CachedChannelModel> cache)
+{
+    m_channelCaches.push_back(cache);
+}
+
+void
+MemoryAccounting::Start(const std::string& path, Time start, Time interval, Time stop)
+{
+    NS_ABORT_MSG_IF(!interval.IsStrictlyPositive(), "The memory sampling interval must be positive");
+    m_interval = interval;
+    m_stop = stop;
+    m_writer = std::make_unique<ColumnarWriter>(path,
+                                                ColumnarWriter::Columns{
+                                                    {"time", ColumnarWriter::DOUBLE},
+                                                    {"rssMiB", ColumnarWriter::DOUBLE},
+                                                    {"heapMiB", ColumnarWriter::DOUBLE},
+                                                    {"objects", ColumnarWriter::UINT64},
+                                                    {"queuedPackets", ColumnarWriter::UINT64},
+                                                    {"queuedBytes", ColumnarWriter::UINT64},
+                                                    {"flows", ColumnarWriter::UINT64},
+                                                    {"flowMonitorBytes", ColumnarWriter::UINT64},
+                                                    {"animationBytes", ColumnarWriter::UINT64},
+                                                    {"channelMatrices", ColumnarWriter::UINT64},
+                                                    {"channelCacheBytes", ColumnarWriter::UINT64},
+                                                });
+    m_event = Simulator::Schedule(start - Simulator::Now(), &MemoryAccounting::Sample, this);
+}
+
+void
+MemoryAccounting::Finish()
+{
+    m_event.Cancel();
+    if (m_writer)
+    {
+        m_writer->Close();
+    }
+}
+
+const std::string&
+MemoryAccounting::GetPath() const
+{
+    return m_writer->GetPath();
+}
+
+const MemoryAccounting::Snapshot&
+MemoryAccounting::GetPeaks() const
+{
+    return m_peaks;
+}
+
+double
+MemoryAccounting::GetSampleSeconds() const
+{
+    return std::chrono::duration<double>(m_sampleTime).count();
+}
+
+double
+MemoryAccounting::GetHeapBytes()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    // Large blocks are mmapped apart from the arenas
+    struct mallinfo2 info = mallinfo2();
+    return static_cast<double>(info.uordblks + info.hblkhd);
+#else
+    return -1;
+#endif
+}
+
+double
+MemoryAccounting::GetRssBytes()
+{
+    // statm: total and resident size in pages
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size = 0;
+    uint64_t resident = 0;
+    statm >> size >> resident;
+    return static_cast<double>(resident) * sysconf(_SC_PAGESIZE);
+}
+
+uint64_t
+MemoryAccounting::GetFlowMonitorBytes() const
+{
+    uint64_t bytes = 0;
+    for (const auto& flow : m_monitor->GetFlowStats())
+    {
+        bytes += g_mapNodeBytes + sizeof(flow) + FlowStatsBytes(flow.second);
+    }
+    for (const auto& probe : m_monitor->GetAllProbes())
+    {
+        for (const auto& flow : probe->GetStats())
+        {
+            bytes += g_mapNodeBytes + sizeof(flow) +
+                     flow.second.packetsDropped.capacity() * sizeof(uint32_t) +
+                     flow.second.bytesDropped.capacity() * sizeof(uint64_t);
+        }
+    }
+    return bytes;
+}
+
+MemoryAccounting::Snapshot
+MemoryAccounting::TakeSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.time = Simulator::Now();
+    snapshot.rssMiB = GetRssBytes() / 1024 / 1024;
+    snapshot.heapMiB = GetHeapBytes() / 1024 / 1024;
+
+    ObjectWalker walker(snapshot);
+    for (auto it = NodeList::Begin(); it != NodeList::End(); ++it)
+    {
+        walker.Visit(*it);
+    }
+    for (auto it = ChannelList::Begin(); it != ChannelList::End(); ++it)
+    {
+        walker.Visit(*it);
+    }
+    walker.Visit(m_monitor);
+
+    if (m_rlcQueues)
+    {
+        snapshot.queuedPackets += m_rlcQueues->GetQueuedPackets();
+        snapshot.queuedBytes += m_rlcQueues->GetQueuedBytes();
+    }
+
+    snapshot.flows = m_monitor->GetFlowStats().size();
+    snapshot.flowMonitorBytes = GetFlowMonitorBytes();
+    snapshot.animationBytes = m_animationSink ? m_animationSink->GetBufferedBytes() : 0;
+    for (const auto& cache : m_channelCaches)
+    {
+        snapshot.channelMatrices += cache->GetEntries();
+        snapshot.channelCacheBytes += cache->GetMatrixBytes();
+    }
+    return snapshot;
+}
+
+void
+MemoryAccounting::Sample()
+{
+    auto start = std::chrono::steady_clock::now();
+    Snapshot snapshot = TakeSnapshot();
+    m_writer->AppendDouble(snapshot.time.GetSeconds());
+    m_writer->AppendDouble(snapshot.rssMiB);
+    m_writer->AppendDouble(snapshot.heapMiB);
+    m_writer->AppendUint64(snapshot.objects);
+    m_writer->AppendUint64(snapshot.queuedPackets);
+    m_writer->AppendUint64(snapshot.queuedBytes);
+    m_writer->AppendUint64(snapshot.flows);
+    m_writer->AppendUint64(snapshot.flowMonitorBytes);
+    m_writer->AppendUint64(snapshot.animationBytes);
+    m_writer->AppendUint64(snapshot.channelMatrices);
+    m_writer->AppendUint64(snapshot.channelCacheBytes);
+    m_writer->EndRow();
+
+    m_peaks.rssMiB = std::max(m_peaks.rssMiB, snapshot.rssMiB);
+    m_peaks.heapMiB = std::max(m_peaks.heapMiB, snapshot.heapMiB);
+    m_peaks.objects = std::max(m_peaks.objects, snapshot.objects);
+    m_peaks.queuedPackets = std::max(m_peaks.queuedPackets, snapshot.queuedPackets);
+    m_peaks.queuedBytes = std::max(m_peaks.queuedBytes, snapshot.queuedBytes);
+    m_peaks.flowMonitorBytes = std::max(m_peaks.flowMonitorBytes, snapshot.flowMonitorBytes);
+    m_peaks.animationBytes = std::max(m_peaks.animationBytes, snapshot.animationBytes);
+    m_peaks.channelCacheBytes = std::max(m_peaks.channelCacheBytes, snapshot.channelCacheBytes);
+    ++m_samples;
+    m_sampleTime += std::chrono::steady_clock::now() - start;
+
+    if (snapshot.time + m_interval <= m_stop)
+    {
+        m_event = Simulator::Schedule(m_interval, &MemoryAccounting::Sample, this);
+    }
+}
+
+void
+MemoryAccounting::Report(std::ostream& os, const Snapshot& snapshot, uint32_t topTypes) const
+{
+    os << "\n  Memory accounting:\n";
+    os << "  Current RSS: " << snapshot.rssMiB << " MiB\n";
+    os << "  Heap in use: " << snapshot.heapMiB << " MiB\n";
+    os << "  Live objects: " << snapshot.objects << " in " << snapshot.objectsByType.size() << " types\n";
+
+    std::vector<std::pair<uint64_t, std::string>> types;
+    for (const auto& type : snapshot.objectsByType)
+    {
+        types.emplace_back(type.second, type.first);
+    }
+    std::sort(types.rbegin(), types.rend());
+    for (std::size_t i = 0; i < types.size() && i < topTypes; ++i)
+    {
+        os << "    " << types[i].second << ": " << types[i].first << "\n";
+    }
+
+    os << "  Packets queued: " << snapshot.queuedPackets << " (" << snapshot.queuedBytes << " B)\n";
+    os << "  FlowMonitor state: " << snapshot.flowMonitorBytes / 1024.0 << " KiB for " << snapshot.flows
+       << " flows\n";
+    if (m_animationSink)
+    {
+        os << "  Animation buffers: " << snapshot.animationBytes / 1024.0 << " KiB\n";
+    }
+    if (!m_channelCaches.empty())
+    {
+        os << "  Channel cache: " << snapshot.channelMatrices << " matrices, "
+           << snapshot.channelCacheBytes / 1024.0 << " KiB\n";
+    }
+    if (m_samples > 0)
+    {
+        os << "  Sampled peak heap: " << m_peaks.heapMiB << " MiB, RSS " << m_peaks.rssMiB << " MiB, "
+           << m_peaks.objects << " objects, " << m_peaks.queuedPackets << " queued packets, "
+           << m_peaks.flowMonitorBytes / 1024.0 << " KiB FlowMonitor state (" << m_samples << " samples, "
+           << GetSampleSeconds() << " s)\n";
+    }
+}
+
+} // namespace ns3
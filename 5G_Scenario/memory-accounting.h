@@ -0,0 +1,110 @@
+#ifndef MEMORY_ACCOUNTING_H
+#define MEMORY_ACCOUNTING_H
+
+#include "columnar-writer.h"
+
+#include "ns3/event-id.h"
+#include "ns3/flow-monitor.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class AnimationTraceSink;
+class CachedChannelModel;
+class RlcQueueManager;
+
+/**
+ * Where the memory of a run goes: resident set and heap of the process, the
+ * live ns-3 Objects by TypeId, the packets held in queues, and the state of
+ * the FlowMonitor, the animation writer and the channel matrix caches.
+ *
+ * Objects are counted by walking what the attribute system can reach (as
+ * ConfigStore does) from every node and channel: aggregates, Pointer
+ * attributes and object containers, so the PHY/MAC/RLC/PDCP instances of
+ * every device are included. Packets are counted in the Queue objects found
+ * on the way and in the RLC queues when the RLC queue manager is installed;
+ * packets are not Objects, so those held elsewhere (in flight in the
+ * spectrum channel, in the HARQ buffers) are not seen. Nothing is created
+ * to measure, so a snapshot does not change the run.
+ *
+ * Snapshot() takes the numbers once; Start() also samples them periodically
+ * into a ColumnarWriter file and keeps their peaks, timing the samples so
+ * that their cost can be taken out of the run wall time.
+ */
+class MemoryAccounting
+{
+  public:
+    struct Snapshot
+    {
+        Time time;
+        double rssMiB{0};
+        double heapMiB{0};
+        uint64_t objects{0};
+        std::map<std::string, uint64_t> objectsByType;
+        uint64_t queuedPackets{0};
+        uint64_t queuedBytes{0};
+        uint64_t flows{0};
+        uint64_t flowMonitorBytes{0};
+        uint64_t animationBytes{0};
+        uint64_t channelMatrices{0};
+        uint64_t channelCacheBytes{0};
+    };
+
+    explicit MemoryAccounting(Ptr<FlowMonitor> monitor);
+
+    void SetAnimationSink(const AnimationTraceSink* sink);
+    void SetRlcQueues(const RlcQueueManager* queues);
+    void AddChannelCache(Ptr<CachedChannelModel> cache);
+
+    /// Sample every interval after `start` until `stop` into the columnar file at path
+    void Start(const std::string& path, Time start, Time interval, Time stop);
+    /// Close the sample file
+    void Finish();
+    const std::string& GetPath() const;
+
+    /// Measure everything now
+    Snapshot TakeSnapshot() const;
+    /// Largest value of each field over the periodic samples
+    const Snapshot& GetPeaks() const;
+    /// Wall time spent taking the periodic samples, in seconds
+    double GetSampleSeconds() const;
+
+    /// Print a snapshot with its topTypes most numerous TypeIds, and the sampled peaks
+    void Report(std::ostream& os, const Snapshot& snapshot, uint32_t topTypes = 10) const;
+
+    /// Bytes allocated on the heap (arena and mmap) and not freed yet, negative when unknown
+    static double GetHeapBytes();
+    /// Current resident set size of the process, in bytes
+    static double GetRssBytes();
+
+  private:
+    void Sample();
+    uint64_t GetFlowMonitorBytes() const;
+
+    Ptr<FlowMonitor> m_monitor;
+    const AnimationTraceSink* m_animationSink{nullptr};
+    const RlcQueueManager* m_rlcQueues{nullptr};
+    std::vector<Ptr<CachedChannelModel>> m_channelCaches;
+
+    Time m_interval;
+    Time m_stop;
+    EventId m_event;
+    std::unique_ptr<ColumnarWriter> m_writer;
+    Snapshot m_peaks;
+    uint64_t m_samples{0};
+    std::chrono::steady_clock::duration m_sampleTime{0};
+};
+
+} // namespace ns3
+
+#endif // MEMORY_ACCOUNTING_H
@@ -0,0 +1,236 @@
+#include "multiplexed-udp-client.h"
+
+#include "ns3/abort.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/seq-ts-header.h"
+#include "ns3/simulator.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(MultiplexedUdpClient);
+
+namespace
+{
+
+const uint64_t g_noTick = std::numeric_limits<uint64_t>::max();
+
+/// Ticks of a duration, to the nearest one
+uint64_t
+RoundTicks(Time time, Time resolution)
+{
+    return (time.GetTimeStep() + resolution.GetTimeStep() / 2) / resolution.GetTimeStep();
+}
+
+/// First tick at or after the current time
+uint64_t
+CurrentTick(Time resolution)
+{
+    return (Simulator::Now().GetTimeStep() + resolution.GetTimeStep() - 1) / resolution.GetTimeStep();
+}
+
+} // namespace
+
+TypeId
+MultiplexedUdpClient::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::MultiplexedUdpClient")
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .AddConstructor<MultiplexedUdpClient>()
+            .AddAttribute("RemotePort",
+                          "Destination port of every flow",
+                          UintegerValue(100),
+                          MakeUintegerAccessor(&MultiplexedUdpClient::m_peerPort),
+                          MakeUintegerChecker<uint16_t>())
+            .AddAttribute("PacketSize",
+                          "UDP payload of a packet, the 12 byte SeqTsHeader included",
+                          UintegerValue(1024),
+                          MakeUintegerAccessor(&MultiplexedUdpClient::m_packetSize),
+                          MakeUintegerChecker<uint32_t>(12))
+            .AddAttribute("Interval",
+                          "Time between two packets of a flow",
+                          TimeValue(Seconds(1)),
+                          MakeTimeAccessor(&MultiplexedUdpClient::m_interval),
+                          MakeTimeChecker())
+            .AddAttribute("MaxPackets",
+                          "Packets sent per flow (0 = no limit)",
+                          UintegerValue(100),
+                          MakeUintegerAccessor(&MultiplexedUdpClient::m_maxPackets),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("Resolution",
+                          "Width of a timing wheel bucket; send times are rounded to it",
+                          TimeValue(MicroSeconds(1)),
+                          MakeTimeAccessor(&MultiplexedUdpClient::m_resolution),
+                          MakeTimeChecker(NanoSeconds(1)))
+            .AddAttribute("WheelSize",
+                          "Buckets of the timing wheel",
+                          UintegerValue(1024),
+                          MakeUintegerAccessor(&MultiplexedUdpClient::m_wheelSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddTraceSource("Tx",
+                            "A packet is sent",
+                            MakeTraceSourceAccessor(&MultiplexedUdpClient::m_txTrace),
+                            "ns3::Packet::TracedCallback");
+    return tid;
+}
+
+MultiplexedUdpClient::MultiplexedUdpClient()
+{
+}
+
+MultiplexedUdpClient::~MultiplexedUdpClient()
+{
+}
+
+void
+MultiplexedUdpClient::AddDestination(Address address, Time delay)
+{
+    NS_ABORT_MSG_IF(!Ipv4Address::IsMatchingType(address), "MultiplexedUdpClient needs IPv4 destinations");
+    Flow flow;
+    flow.address = InetSocketAddress(Ipv4Address::ConvertFrom(address), m_peerPort);
+    flow.delay = delay;
+    m_flows.push_back(flow);
+    if (m_running)
+    {
+        uint64_t now = CurrentTick(m_resolution);
+        m_flows.back().due = now + RoundTicks(delay, m_resolution);
+        Insert(m_flows.size() - 1);
+        Simulator::Cancel(m_sendEvent);
+        ScheduleNextTick(now);
+    }
+}
+
+uint32_t
+MultiplexedUdpClient::GetDestinations() const
+{
+    return m_flows.size();
+}
+
+uint64_t
+MultiplexedUdpClient::GetSent() const
+{
+    return m_sent;
+}
+
+void
+MultiplexedUdpClient::DoDispose()
+{
+    m_socket = nullptr;
+    m_flows.clear();
+    m_buckets.clear();
+    Application::DoDispose();
+}
+
+void
+MultiplexedUdpClient::StartApplication()
+{
+    if (!m_socket)
+    {
+        m_socket = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
+        m_socket->Bind();
+    }
+
+    m_intervalTicks = std::max<uint64_t>(1, RoundTicks(m_interval, m_resolution));
+    m_buckets.assign(m_wheelSize, {});
+    m_bucketDue.assign(m_wheelSize, g_noTick);
+    m_running = true;
+
+    // Every flow starts at its delay, as a UdpClient started at the same time would
+    uint64_t now = CurrentTick(m_resolution);
+    for (uint32_t i = 0; i < m_flows.size(); ++i)
+    {
+        m_flows[i].due = now + RoundTicks(m_flows[i].delay, m_resolution);
+        Insert(i);
+    }
+    ScheduleNextTick(now);
+}
+
+void
+MultiplexedUdpClient::StopApplication()
+{
+    m_running = false;
+    Simulator::Cancel(m_sendEvent);
+}
+
+void
+MultiplexedUdpClient::Insert(uint32_t flow)
+{
+    uint64_t due = m_flows[flow].due;
+    uint32_t bucket = due % m_wheelSize;
+    m_buckets[bucket].push_back(flow);
+    m_bucketDue[bucket] = std::min(m_bucketDue[bucket], due);
+}
+
+void
+MultiplexedUdpClient::SendTick()
+{
+    uint64_t tick = Simulator::Now().GetTimeStep() / m_resolution.GetTimeStep();
+    uint32_t bucket = tick % m_wheelSize;
+
+    // Flows of later revolutions go back to the same bucket
+    m_tickFlows.swap(m_buckets[bucket]);
+    m_bucketDue[bucket] = g_noTick;
+    for (uint32_t id : m_tickFlows)
+    {
+        Flow& flow = m_flows[id];
+        if (flow.due != tick)
+        {
+            Insert(id);
+            continue;
+        }
+
+        SeqTsHeader seqTs;
+        seqTs.SetSeq(flow.sent);
+        Ptr<Packet> packet = Create<Packet>(m_packetSize - seqTs.GetSerializedSize());
+        packet->AddHeader(seqTs);
+        m_txTrace(packet);
+        if (m_socket->SendTo(packet, 0, flow.address) >= 0)
+        {
+            ++m_sent;
+        }
+
+        ++flow.sent;
+        if (m_maxPackets == 0 || flow.sent < m_maxPackets)
+        {
+            flow.due += m_intervalTicks;
+            Insert(id);
+        }
+    }
+    m_tickFlows.clear();
+    ScheduleNextTick(tick + 1);
+}
+
+void
+MultiplexedUdpClient::ScheduleNextTick(uint64_t tick)
+{
+    // Look one revolution ahead, then fall back to the earliest due tick of all the buckets
+    uint64_t next = g_noTick;
+    for (uint64_t t = tick; t < tick + m_wheelSize; ++t)
+    {
+        if (m_bucketDue[t % m_wheelSize] == t)
+        {
+            next = t;
+            break;
+        }
+    }
+    if (next == g_noTick)
+    {
+        next = *std::min_element(m_bucketDue.begin(), m_bucketDue.end());
+    }
+    if (next == g_noTick)
+    {
+        return;
+    }
+    Time at = TimeStep(next * m_resolution.GetTimeStep());
+    m_sendEvent = Simulator::Schedule(at - Simulator::Now(), &MultiplexedUdpClient::SendTick, this);
+}
+
+} // namespace ns3
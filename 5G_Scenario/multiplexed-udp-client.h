@@ -0,0 +1,90 @@
+#ifndef MULTIPLEXED_UDP_CLIENT_H
+#define MULTIPLEXED_UDP_CLIENT_H
+
+#include "ns3/address.h"
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/socket.h"
+#include "ns3/traced-callback.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * One application that sends the UdpClient traffic of many destinations.
+ *
+ * Every destination is a flow of PacketSize byte packets every Interval,
+ * numbered by its own SeqTsHeader sequence, so a UdpServer per destination
+ * sees the same packets as from a UdpClient of its own. All the flows share
+ * one unconnected socket and one pending event: the flows are kept in a
+ * hashed timing wheel of WheelSize buckets of Resolution each, and one
+ * event sends every packet due in a tick and schedules the next non-empty
+ * tick. The send times are rounded to the Resolution grid, so an Interval
+ * that is a multiple of it keeps the times of UdpClient.
+ */
+class MultiplexedUdpClient : public Application
+{
+  public:
+    static TypeId GetTypeId();
+
+    MultiplexedUdpClient();
+    ~MultiplexedUdpClient() override;
+
+    /// Add a flow to an IPv4 address, starting delay after the application
+    void AddDestination(Address address, Time delay = Seconds(0));
+
+    uint32_t GetDestinations() const;
+    uint64_t GetSent() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    struct Flow
+    {
+        Address address;
+        /// Start of the flow after the start of the application
+        Time delay;
+        uint32_t sent{0};
+        /// Tick of the next packet
+        uint64_t due{0};
+    };
+
+    void StartApplication() override;
+    void StopApplication() override;
+
+    void Insert(uint32_t flow);
+    /// Send the packets of the current tick and schedule the next tick
+    void SendTick();
+    /// Schedule the first tick, at or after the given one, that has a packet due
+    void ScheduleNextTick(uint64_t tick);
+
+    uint16_t m_peerPort;
+    uint32_t m_packetSize;
+    Time m_interval;
+    uint32_t m_maxPackets;
+    Time m_resolution;
+    uint32_t m_wheelSize;
+
+    Ptr<Socket> m_socket;
+    EventId m_sendEvent;
+    bool m_running{false};
+
+    std::vector<Flow> m_flows;
+    /// Flows of every bucket and the earliest due tick in it
+    std::vector<std::vector<uint32_t>> m_buckets;
+    std::vector<uint64_t> m_bucketDue;
+    /// Flows of the tick being sent
+    std::vector<uint32_t> m_tickFlows;
+    uint64_t m_intervalTicks{1};
+    uint64_t m_sent{0};
+
+    TracedCallback<Ptr<const Packet>> m_txTrace;
+};
+
+} // namespace ns3
+
+#endif // MULTIPLEXED_UDP_CLIENT_H
@@ -0,0 +1,222 @@
+#include "profiling-simulator-impl.h"
+
+#include "ns3/event-impl.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(ProfilingSimulatorImpl);
+
+/// Times the original event and reports it to the simulator implementation
+class ProfiledEvent : public EventImpl
+{
+  public:
+    ProfiledEvent(ProfilingSimulatorImpl* simulator, EventImpl* event)
+        : m_simulator(simulator),
+          m_event(event, false)
+    {
+    }
+
+    // Freed wrappers are chained through their own memory and reused by the
+    // next events of the same thread
+    static void* operator new(std::size_t size)
+    {
+        if (!s_free)
+        {
+            return ::operator new(size);
+        }
+        FreeWrapper* memory = s_free;
+        s_free = memory->next;
+        return memory;
+    }
+
+    static void operator delete(void* memory)
+    {
+        auto wrapper = static_cast<FreeWrapper*>(memory);
+        wrapper->next = s_free;
+        s_free = wrapper;
+    }
+
+  protected:
+    void Notify() override
+    {
+        auto start = std::chrono::steady_clock::now();
+        m_event->Invoke();
+        m_simulator->Account(*m_event, std::chrono::steady_clock::now() - start);
+    }
+
+  private:
+    ProfilingSimulatorImpl* m_simulator;
+    Ptr<EventImpl> m_event;
+
+    struct FreeWrapper
+    {
+        FreeWrapper* next;
+    };
+
+    static thread_local FreeWrapper* s_free;
+};
+
+thread_local ProfiledEvent::FreeWrapper* ProfiledEvent::s_free = nullptr;
+
+namespace
+{
+
+/// Empty event of the overhead calibration
+class CalibrationEvent : public EventImpl
+{
+  protected:
+    void Notify() override
+    {
+    }
+};
+
+// Readable event source: the class of a member function handler if the type
+// names one, otherwise the demangled type of the event
+std::string
+SourceName(const std::type_info& type)
+{
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+    std::string name = status == 0 ? demangled : type.name();
+    std::free(demangled);
+
+    auto member = name.find("::*)");
+    if (member != std::string::npos)
+    {
+        auto open = name.rfind('(', member);
+        if (open != std::string::npos)
+        {
+            name = name.substr(open + 1, member - open - 1);
+        }
+    }
+    if (name.rfind("ns3::", 0) == 0)
+    {
+        name = name.substr(5);
+    }
+    return name.size() > 60 ? name.substr(0, 57) + "..." : name;
+}
+
+} // namespace
+
+TypeId
+ProfilingSimulatorImpl::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::ProfilingSimulatorImpl")
+                            .SetParent<DefaultSimulatorImpl>()
+                            .SetGroupName("Core")
+                            .AddConstructor<ProfilingSimulatorImpl>();
+    return tid;
+}
+
+EventImpl*
+ProfilingSimulatorImpl::Wrap(EventImpl* event)
+{
+    return new ProfiledEvent(this, event);
+}
+
+EventId
+ProfilingSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
+{
+    return DefaultSimulatorImpl::Schedule(delay, Wrap(event));
+}
+
+void
+ProfilingSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event)
+{
+    DefaultSimulatorImpl::ScheduleWithContext(context, delay, Wrap(event));
+}
+
+EventId
+ProfilingSimulatorImpl::ScheduleNow(EventImpl* event)
+{
+    return DefaultSimulatorImpl::ScheduleNow(Wrap(event));
+}
+
+void
+ProfilingSimulatorImpl::Account(const EventImpl& event, std::chrono::steady_clock::duration wallTime)
+{
+    Source& source = m_sources[&typeid(event)];
+    ++source.events;
+    source.wallTime += wallTime;
+}
+
+double
+ProfilingSimulatorImpl::MeasureOverhead(uint32_t events)
+{
+    // Schedule() allocates the original event either way; the wrapper adds
+    // its own allocation, the clock reads and the accounting
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    for (uint32_t i = 0; i < events; ++i)
+    {
+        Ptr<EventImpl> event(new CalibrationEvent(), false);
+        event->Invoke();
+    }
+    auto bare = Clock::now() - start;
+    start = Clock::now();
+    for (uint32_t i = 0; i < events; ++i)
+    {
+        Ptr<EventImpl> event(Wrap(new CalibrationEvent()), false);
+        event->Invoke();
+    }
+    auto wrapped = Clock::now() - start;
+    m_sources.erase(&typeid(CalibrationEvent));
+    return std::max(0.0, std::chrono::duration<double, std::nano>(wrapped - bare).count() / events);
+}
+
+void
+ProfilingSimulatorImpl::Report(std::ostream& os, double runSeconds, uint32_t top)
+{
+    double overhead = MeasureOverhead(1000000);
+
+    // Several event types can map to the same handler class, and a type can
+    // have more than one type_info across shared libraries
+    std::unordered_map<std::string, Source> bySource;
+    Source total;
+    for (const auto& entry : m_sources)
+    {
+        Source& source = bySource[SourceName(*entry.first)];
+        source.events += entry.second.events;
+        source.wallTime += entry.second.wallTime;
+        total.events += entry.second.events;
+        total.wallTime += entry.second.wallTime;
+    }
+
+    std::vector<std::pair<std::string, Source>> sorted(bySource.begin(), bySource.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+        return a.second.wallTime > b.second.wallTime;
+    });
+
+    double totalSeconds = std::chrono::duration<double>(total.wallTime).count();
+    os << "\n  Event hot spots (" << total.events << " events, " << totalSeconds << " s in handlers):\n";
+    os << "  " << std::left << std::setw(62) << "source" << std::right << std::setw(12) << "events"
+       << std::setw(12) << "wall s" << std::setw(8) << "%" << std::setw(12) << "ns/event" << "\n";
+
+    std::ios_base::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << std::fixed;
+    for (std::size_t i = 0; i < sorted.size() && i < top; ++i)
+    {
+        double seconds = std::chrono::duration<double>(sorted[i].second.wallTime).count();
+        double share = totalSeconds > 0 ? 100 * seconds / totalSeconds : 0.0;
+        os << "  " << std::left << std::setw(62) << sorted[i].first << std::right << std::setw(12)
+           << sorted[i].second.events << std::setw(12) << std::setprecision(3) << seconds << std::setw(8)
+           << std::setprecision(1) << share << std::setw(12) << std::setprecision(0)
+           << seconds * 1e9 / sorted[i].second.events << "\n";
+    }
+    os.flags(flags);
+    os.precision(precision);
+    os << "  Profiler overhead: " << overhead << " ns/event, "
+       << (runSeconds > 0 ? 100 * overhead * 1e-9 * total.events / runSeconds : 0.0)
+       << " % of the run wall time\n";
+}
+
+} // namespace ns3
@@ -0,0 +1,202 @@
+#include "replication-report.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+
+namespace ns3
+{
+
+namespace
+{
+
+// Two-sided 95% quantile of the Student t distribution
+double
+StudentT95(std::size_t degreesOfFreedom)
+{
+    static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306,
+                                   2.262,  2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120,
+                                   2.110,  2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064,
+                                   2.060,  2.056, 2.052, 2.048, 2.045, 2.042};
+    if (degreesOfFreedom == 0)
+    {
+        return 0.0;
+    }
+    if (degreesOfFreedom <= 30)
+    {
+        return table[degreesOfFreedom - 1];
+    }
+    return degreesOfFreedom <= 60 ? 2.000 : degreesOfFreedom <= 120 ? 1.980 : 1.960;
+}
+
+// Parse a KPI of the merged table, false if it is missing or not a number
+bool
+ParseValue(const std::string& text, double& value)
+{
+    if (text.empty())
+    {
+        return false;
+    }
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return end != text.c_str() && std::isfinite(value);
+}
+
+} // namespace
+
+ReplicationReport::ReplicationReport(const std::vector<SweepRunner::Point>& points,
+                                     const std::string& replicationName,
+                                     const std::vector<Metric>& metrics)
+    : m_replicationName(replicationName),
+      m_metrics(metrics)
+{
+    // First group seen with the same values in all but the last dimension
+    std::map<std::string, std::string> firstOfContext;
+    for (const auto& point : points)
+    {
+        if (point.exitStatus != 0)
+        {
+            continue;
+        }
+        std::string group;
+        std::string replication;
+        // Values of the group without the last compared dimension
+        std::string context;
+        std::string last;
+        for (const auto& value : point.values)
+        {
+            if (value.first == replicationName)
+            {
+                replication = value.second;
+            }
+            else
+            {
+                context += last;
+                last = (group.empty() ? "" : " ") + value.first + "=" + value.second;
+                group += last;
+            }
+        }
+        if (group.empty())
+        {
+            group = "all";
+        }
+        if (std::find(m_groups.begin(), m_groups.end(), group) == m_groups.end())
+        {
+            m_groups.push_back(group);
+            m_baselines[group] = firstOfContext.emplace(context, group).first->second;
+        }
+        for (const auto& metric : metrics)
+        {
+            auto result = point.results.find(metric.first);
+            double value;
+            if (result != point.results.end() && ParseValue(result->second, value))
+            {
+                m_samples[group][metric.first][replication] = value;
+            }
+        }
+    }
+}
+
+std::pair<double, double>
+ReplicationReport::ConfidenceInterval(const std::vector<double>& samples)
+{
+    if (samples.empty())
+    {
+        return {0.0, 0.0};
+    }
+    double sum = 0.0;
+    for (double sample : samples)
+    {
+        sum += sample;
+    }
+    double mean = sum / samples.size();
+    if (samples.size() < 2)
+    {
+        return {mean, 0.0};
+    }
+    double squares = 0.0;
+    for (double sample : samples)
+    {
+        squares += (sample - mean) * (sample - mean);
+    }
+    double stdDev = std::sqrt(squares / (samples.size() - 1));
+    return {mean, StudentT95(samples.size() - 1) * stdDev / std::sqrt(samples.size())};
+}
+
+void
+ReplicationReport::Print(std::ostream& os) const
+{
+    auto printInterval = [&os](const std::string& label, const std::vector<double>& samples) {
+        os << "    " << std::left << std::setw(24) << label << std::right;
+        if (samples.empty())
+        {
+            os << "no samples";
+            return;
+        }
+        auto ci = ConfidenceInterval(samples);
+        os << ci.first << " +/- " << ci.second << " (n=" << samples.size() << ")";
+    };
+
+    os << "\nReplications, mean +/- 95% confidence interval:\n";
+    for (const auto& group : m_groups)
+    {
+        os << "  " << group << "\n";
+        for (const auto& metric : m_metrics)
+        {
+            std::vector<double> samples;
+            auto groupSamples = m_samples.find(group);
+            if (groupSamples != m_samples.end() && groupSamples->second.count(metric.first))
+            {
+                for (const auto& sample : groupSamples->second.at(metric.first))
+                {
+                    samples.push_back(sample.second);
+                }
+            }
+            printInterval(metric.second, samples);
+            os << "\n";
+        }
+    }
+
+    if (m_groups.size() < 2)
+    {
+        return;
+    }
+
+    // Differences on common random numbers: pair the replications by id
+    os << "\nPaired differences against the baseline (same " << m_replicationName << "):\n";
+    for (std::size_t g = 0; g < m_groups.size(); ++g)
+    {
+        const std::string& baseline = m_baselines.at(m_groups[g]);
+        if (baseline == m_groups[g])
+        {
+            continue;
+        }
+        os << "  " << m_groups[g] << " - " << baseline << "\n";
+        for (const auto& metric : m_metrics)
+        {
+            std::vector<double> differences;
+            auto base = m_samples.find(baseline);
+            auto other = m_samples.find(m_groups[g]);
+            if (base != m_samples.end() && other != m_samples.end() &&
+                base->second.count(metric.first) && other->second.count(metric.first))
+            {
+                const Samples& baseSamples = base->second.at(metric.first);
+                for (const auto& sample : other->second.at(metric.first))
+                {
+                    auto match = baseSamples.find(sample.first);
+                    if (match != baseSamples.end())
+                    {
+                        differences.push_back(sample.second - match->second);
+                    }
+                }
+            }
+            printInterval(metric.second, differences);
+            auto ci = ConfidenceInterval(differences);
+            bool significant = differences.size() > 1 && std::abs(ci.first) > ci.second;
+            os << (significant ? "  significant" : "") << "\n";
+        }
+    }
+}
+
+} // namespace ns3
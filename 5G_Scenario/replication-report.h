@@ -0,0 +1,57 @@
+#ifndef REPLICATION_REPORT_H
+#define REPLICATION_REPORT_H
+
+#include "sweep-runner.h"
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Statistics over the independent replications of a sweep.
+ *
+ * The points of the sweep are grouped by every grid value except the
+ * replication dimension (RngRun). For each group it reports the mean and the
+ * 95% confidence interval (Student t) of the selected KPIs. It also reports
+ * the paired differences of every group against its baseline, the first
+ * value of the last compared dimension with the same values in the others
+ * (with "traffic=voice,lowlatency;scheduler=PF,RR" the baseline of
+ * lowlatency RR is lowlatency PF), computed over the replications that share
+ * the same RngRun and hence the same random numbers.
+ */
+class ReplicationReport
+{
+  public:
+    /// KPI column of the merged sweep table and the label to print it with
+    using Metric = std::pair<std::string, std::string>;
+
+    ReplicationReport(const std::vector<SweepRunner::Point>& points,
+                      const std::string& replicationName,
+                      const std::vector<Metric>& metrics);
+
+    void Print(std::ostream& os) const;
+
+    /// Mean and half width of the 95% confidence interval of the samples
+    static std::pair<double, double> ConfidenceInterval(const std::vector<double>& samples);
+
+  private:
+    /// Value of a metric in each replication, by replication id
+    using Samples = std::map<std::string, double>;
+
+    std::string m_replicationName;
+    std::vector<Metric> m_metrics;
+    std::vector<std::string> m_groups;
+    /// Baseline of every group
+    std::map<std::string, std::string> m_baselines;
+    /// Samples by group and metric column
+    std::map<std::string, std::map<std::string, Samples>> m_samples;
+};
+
+} // namespace ns3
+
+#endif // REPLICATION_REPORT_H
@@ -0,0 +1,281 @@
+#include "results-writer.h"
+
+#include "ns3/abort.h"
+
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3
+{
+
+namespace
+{
+
+/// Decimal number as printed by an ostream, which is also a valid JSON number
+bool
+IsNumber(const std::string& text)
+{
+    if (text.empty() || !(std::isdigit(static_cast<unsigned char>(text[0])) || text[0] == '-') ||
+        !std::isdigit(static_cast<unsigned char>(text.back())) || text.find_first_of("xX") != std::string::npos)
+    {
+        return false;
+    }
+    char* end = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    return *end == '\0' && std::isfinite(value);
+}
+
+std::string
+QuoteJson(const std::string& text)
+{
+    std::string quoted = "\"";
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            quoted += '\\';
+            quoted += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            char escape[8];
+            std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+            quoted += escape;
+        }
+        else
+        {
+            quoted += c;
+        }
+    }
+    return quoted + "\"";
+}
+
+std::string
+QuoteCsv(const std::string& text)
+{
+    if (text.find_first_of(",\"\r\n") == std::string::npos)
+    {
+        return text;
+    }
+    std::string quoted = "\"";
+    for (char c : text)
+    {
+        quoted += c;
+        if (c == '"')
+        {
+            quoted += '"';
+        }
+    }
+    return quoted + "\"";
+}
+
+/// Append to a file under an exclusive lock, with the header if the file is
+/// new; an existing file must start with the same header
+void
+AppendFile(const std::string& path, const std::string& header, const std::string& rows)
+{
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    NS_ABORT_MSG_IF(fd < 0, "Cannot open the results file " << path);
+    flock(fd, LOCK_EX);
+    struct stat status;
+    bool created = fstat(fd, &status) == 0 && status.st_size == 0;
+    if (!created && !header.empty())
+    {
+        std::string existing(header.size(), '\0');
+        ssize_t n = pread(fd, &existing[0], existing.size(), 0);
+        NS_ABORT_MSG_IF(n != static_cast<ssize_t>(header.size()) || existing != header,
+                        "The results file " << path << " has other columns than this run, write to "
+                                            << "another --resultsTag or outputDir");
+    }
+    std::string data = created ? header + rows : rows;
+    std::size_t written = 0;
+    while (written < data.size())
+    {
+        ssize_t n = write(fd, data.data() + written, data.size() - written);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        NS_ABORT_MSG_IF(n < 0, "Cannot write the results file " << path);
+        written += n;
+    }
+    flock(fd, LOCK_UN);
+    close(fd);
+}
+
+} // namespace
+
+ResultsWriter::ResultsWriter(const std::string& format, const Tags& tags)
+    : m_csv(format == "csv"),
+      m_tags(tags)
+{
+    NS_ABORT_MSG_IF(format != "jsonl" && format != "csv",
+                    "Unknown results format " << format << " (expected jsonl or csv)");
+}
+
+void
+ResultsWriter::BeginRecord(const std::string& kind)
+{
+    m_current = m_tables.size();
+    for (std::size_t i = 0; i < m_tables.size(); ++i)
+    {
+        if (m_tables[i].kind == kind)
+        {
+            m_current = i;
+        }
+    }
+    if (m_current == m_tables.size())
+    {
+        m_tables.push_back({kind, "", "", 0, {}});
+    }
+
+    m_firstField = true;
+    m_tables[m_current].lastFields.clear();
+    if (!m_csv)
+    {
+        m_tables[m_current].rows += '{';
+    }
+    m_inTags = true;
+    AddField("record", kind, true);
+    for (const auto& tag : m_tags)
+    {
+        AddText(tag.first, tag.second);
+    }
+    m_inTags = false;
+}
+
+void
+ResultsWriter::Add(const std::string& name, double value)
+{
+    if (!std::isfinite(value))
+    {
+        AddField(name, m_csv ? "" : "null", false);
+        return;
+    }
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.10g", value);
+    AddField(name, text, false);
+}
+
+void
+ResultsWriter::Add(const std::string& name, uint32_t value)
+{
+    AddField(name, std::to_string(value), false);
+}
+
+void
+ResultsWriter::Add(const std::string& name, uint64_t value)
+{
+    AddField(name, std::to_string(value), false);
+}
+
+void
+ResultsWriter::Add(const std::string& name, const std::string& value)
+{
+    AddField(name, value, true);
+}
+
+void
+ResultsWriter::EndRecord()
+{
+    Table& table = m_tables[m_current];
+    table.rows += m_csv ? "\n" : "}\n";
+    if (table.records == 0 && m_csv)
+    {
+        table.header += '\n';
+    }
+    ++table.records;
+}
+
+std::vector<std::string>
+ResultsWriter::Write(const std::string& prefix) const
+{
+    std::vector<std::string> paths;
+    if (m_csv)
+    {
+        for (const auto& table : m_tables)
+        {
+            paths.push_back(prefix + "-" + table.kind + "s.csv");
+            AppendFile(paths.back(), table.header, table.rows);
+        }
+        return paths;
+    }
+
+    // Flows and run of the same run stay together in the file
+    std::string rows;
+    for (const auto& table : m_tables)
+    {
+        rows += table.rows;
+    }
+    paths.push_back(prefix + "-results.jsonl");
+    AppendFile(paths.back(), "", rows);
+    return paths;
+}
+
+void
+ResultsWriter::WriteLastRecord(const std::string& kind, const std::string& path) const
+{
+    std::string header;
+    std::string row;
+    for (const auto& table : m_tables)
+    {
+        if (table.kind != kind)
+        {
+            continue;
+        }
+        for (std::size_t i = 0; i < table.lastFields.size(); ++i)
+        {
+            header += (i > 0 ? "," : "") + QuoteCsv(table.lastFields[i].first);
+            row += (i > 0 ? "," : "") + QuoteCsv(table.lastFields[i].second);
+        }
+    }
+    std::ofstream file(path, std::ios::trunc);
+    NS_ABORT_MSG_IF(!file, "Cannot write the record file " << path);
+    file << header << "\n" << row << "\n";
+}
+
+void
+ResultsWriter::AddField(const std::string& name, const std::string& value, bool quoted)
+{
+    Table& table = m_tables[m_current];
+    if (!m_inTags)
+    {
+        // The CSV value: empty for a JSON null
+        table.lastFields.emplace_back(name, value == "null" && !quoted ? "" : value);
+    }
+    if (!m_firstField)
+    {
+        table.rows += ',';
+    }
+    if (m_csv)
+    {
+        table.rows += quoted ? QuoteCsv(value) : value;
+        if (table.records == 0)
+        {
+            table.header += (m_firstField ? "" : ",") + QuoteCsv(name);
+        }
+    }
+    else
+    {
+        table.rows += QuoteJson(name) + ':' + (quoted ? QuoteJson(value) : value);
+    }
+    m_firstField = false;
+}
+
+void
+ResultsWriter::AddText(const std::string& name, const std::string& value)
+{
+    bool plain = IsNumber(value) || value == "true" || value == "false";
+    AddField(name, value, !plain);
+}
+
+} // namespace ns3
@@ -0,0 +1,76 @@
+#ifndef RESULTS_WRITER_H
+#define RESULTS_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Structured results of a run: one record per flow and one summary record,
+ * each tagged with the same values (every scenario parameter, the scheduler
+ * TypeId, the RNG seed and run).
+ *
+ * Records are built field by field in memory and appended to the dataset in
+ * one write at the end of the run, under an exclusive lock, so thousands of
+ * runs (or parallel sweep processes) can add to the same files:
+ * - jsonl: PREFIX-results.jsonl, one JSON object per line with a "record"
+ *   field set to "flow" or "run"
+ * - csv: PREFIX-flows.csv and PREFIX-runs.csv, with a header line written
+ *   when the file is created; appending records with other columns to an
+ *   existing file aborts instead of misaligning them
+ * Numbers are written as numbers; tag values that parse as numbers or
+ * booleans too.
+ */
+class ResultsWriter
+{
+  public:
+    using Tags = std::vector<std::pair<std::string, std::string>>;
+
+    /// Format is jsonl or csv, aborting on anything else
+    ResultsWriter(const std::string& format, const Tags& tags);
+
+    /// Start a record, "flow" or "run"
+    void BeginRecord(const std::string& kind);
+    void Add(const std::string& name, double value);
+    void Add(const std::string& name, uint32_t value);
+    void Add(const std::string& name, uint64_t value);
+    void Add(const std::string& name, const std::string& value);
+    void EndRecord();
+
+    /// Append the records to the files of the given path prefix, returns the paths written
+    std::vector<std::string> Write(const std::string& prefix) const;
+
+    /// Write the fields of the last record of a kind, without the tags, as a two line CSV file
+    void WriteLastRecord(const std::string& kind, const std::string& path) const;
+
+  private:
+    struct Table
+    {
+        std::string kind;
+        std::string header;
+        std::string rows;
+        uint64_t records{0};
+        /// Fields of the last record after the tags, as text
+        std::vector<std::pair<std::string, std::string>> lastFields;
+    };
+
+    void AddField(const std::string& name, const std::string& value, bool quoted);
+    /// Append a tag or string value, as a number when it is one
+    void AddText(const std::string& name, const std::string& value);
+
+    bool m_csv;
+    Tags m_tags;
+    std::vector<Table> m_tables;
+    std::size_t m_current{0};
+    bool m_firstField{true};
+    bool m_inTags{false};
+};
+
+} // namespace ns3
+
+#endif // RESULTS_WRITER_H
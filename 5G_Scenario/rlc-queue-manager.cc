@@ -0,0 +1,354 @@
+#include "rlc-queue-manager.h"
+
+#include "ns3/abort.h"
+#include "ns3/lte-enb-component-carrier-manager.h"
+#include "ns3/lte-enb-rrc.h"
+#include "ns3/lte-radio-bearer-info.h"
+#include "ns3/lte-rlc-header.h"
+#include "ns3/lte-rlc-um.h"
+#include "ns3/nr-gnb-net-device.h"
+#include "ns3/object-map.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+namespace
+{
+
+// Below one full size packet in the queue CoDel never drops
+const uint32_t g_codelMinBytes = 1500;
+
+} // namespace
+
+CodelController::CodelController(Time target, Time interval)
+    : m_target(target),
+      m_interval(interval)
+{
+}
+
+bool
+CodelController::Drop(Time now, Time sojourn, uint32_t queueBytes)
+{
+    bool okToDrop = false;
+    if (sojourn < m_target || queueBytes <= g_codelMinBytes)
+    {
+        m_firstAboveTime = Time(0);
+    }
+    else if (m_firstAboveTime.IsZero())
+    {
+        m_firstAboveTime = now + m_interval;
+    }
+    else
+    {
+        okToDrop = now >= m_firstAboveTime;
+    }
+
+    if (m_dropping)
+    {
+        if (!okToDrop)
+        {
+            m_dropping = false;
+            return false;
+        }
+        if (now >= m_dropNext)
+        {
+            ++m_count;
+            m_dropNext = ControlLaw(m_dropNext);
+            return true;
+        }
+        return false;
+    }
+    if (!okToDrop)
+    {
+        return false;
+    }
+
+    // Start dropping again at about the rate the last dropping state ended with
+    m_dropping = true;
+    uint32_t delta = m_count - m_lastCount;
+    m_count = (delta > 1 && now - m_dropNext < m_interval * 16) ? delta : 1;
+    m_lastCount = m_count;
+    m_dropNext = ControlLaw(now);
+    return true;
+}
+
+Time
+CodelController::ControlLaw(Time t) const
+{
+    return t + Seconds(m_interval.GetSeconds() / std::sqrt(m_count));
+}
+
+RlcQueueManager::RlcSapProvider::RlcSapProvider(RlcQueueManager* manager, Bearer* bearer)
+    : m_manager(manager),
+      m_bearer(bearer)
+{
+}
+
+void
+RlcQueueManager::RlcSapProvider::TransmitPdcpPdu(TransmitPdcpPduParameters params)
+{
+    m_manager->Enqueue(m_bearer, params);
+}
+
+RlcQueueManager::MacSapProvider::MacSapProvider(RlcQueueManager* manager, Bearer* bearer)
+    : m_manager(manager),
+      m_bearer(bearer)
+{
+}
+
+void
+RlcQueueManager::MacSapProvider::TransmitPdu(TransmitPduParameters params)
+{
+    m_manager->Dequeue(m_bearer, params);
+    m_bearer->mac->TransmitPdu(params);
+}
+
+void
+RlcQueueManager::MacSapProvider::ReportBufferStatus(ReportBufferStatusParameters params)
+{
+    m_manager->BufferStatus(m_bearer, params);
+    m_bearer->mac->ReportBufferStatus(params);
+}
+
+RlcQueueManager::RlcQueueManager(uint32_t maxBytes,
+                                 uint32_t maxPackets,
+                                 const std::string& aqm,
+                                 Time target,
+                                 Time interval)
+    : m_maxBytes(maxBytes),
+      m_maxPackets(maxPackets),
+      m_codel(aqm == "codel"),
+      m_target(target),
+      m_interval(interval)
+{
+    NS_ABORT_MSG_IF(aqm != "none" && aqm != "codel", "Unknown RLC AQM " << aqm << " (expected none or codel)");
+    NS_ABORT_MSG_IF(m_codel && (target <= Time(0) || interval <= Time(0)),
+                    "CoDel needs a positive target and interval");
+}
+
+RlcQueueManager::~RlcQueueManager()
+{
+}
+
+void
+RlcQueueManager::Install(const NetDeviceContainer& gnbDevices)
+{
+    m_start = Simulator::Now();
+    for (uint32_t i = 0; i < gnbDevices.GetN(); ++i)
+    {
+        Ptr<NrGnbNetDevice> gnb = DynamicCast<NrGnbNetDevice>(gnbDevices.Get(i));
+        NS_ABORT_MSG_IF(!gnb, "The RLC queue manager needs gNB devices");
+        PointerValue ccm;
+        gnb->GetAttribute("LteEnbComponentCarrierManager", ccm);
+        m_rrcs.push_back(gnb->GetRrc());
+        m_macs.push_back(ccm.Get<LteEnbComponentCarrierManager>()->GetLteMacSapProvider());
+        m_rrcs.back()->TraceConnect("DrbCreated",
+                                    std::to_string(i),
+                                    MakeCallback(&RlcQueueManager::DrbCreated, this));
+    }
+}
+
+void
+RlcQueueManager::DrbCreated(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti, uint8_t lcid)
+{
+    uint32_t gnb = std::stoul(context);
+    ObjectMapValue drbs;
+    m_rrcs[gnb]->GetUeManager(rnti)->GetAttribute("DataRadioBearerMap", drbs);
+    for (auto it = drbs.Begin(); it != drbs.End(); ++it)
+    {
+        Ptr<LteDataRadioBearerInfo> drb = DynamicCast<LteDataRadioBearerInfo>(it->second);
+        if (!drb || drb->m_logicalChannelIdentity != lcid || !DynamicCast<LteRlcUm>(drb->m_rlc))
+        {
+            continue;
+        }
+
+        auto bearer = std::make_unique<Bearer>();
+        bearer->cellId = cellId;
+        bearer->rnti = rnti;
+        bearer->lcid = lcid;
+        bearer->rlc = drb->m_rlc->GetLteRlcSapProvider();
+        bearer->mac = m_macs[gnb];
+        bearer->lastChange = Simulator::Now();
+        bearer->rlcSap = std::make_unique<RlcSapProvider>(this, bearer.get());
+        bearer->macSap = std::make_unique<MacSapProvider>(this, bearer.get());
+        if (m_codel)
+        {
+            bearer->codel = std::make_unique<CodelController>(m_target, m_interval);
+        }
+        drb->m_pdcp->SetLteRlcSapProvider(bearer->rlcSap.get());
+        drb->m_rlc->SetLteMacSapProvider(bearer->macSap.get());
+        m_bearers.push_back(std::move(bearer));
+    }
+}
+
+uint64_t
+RlcQueueManager::GetBytes(const Bearer& bearer)
+{
+    return bearer.sduBytes - bearer.headSent;
+}
+
+void
+RlcQueueManager::Integrate(Bearer* bearer, Time now)
+{
+    bearer->byteSeconds += GetBytes(*bearer) * (now - bearer->lastChange).GetSeconds();
+    bearer->lastChange = now;
+}
+
+void
+RlcQueueManager::Enqueue(Bearer* bearer, LteRlcSapProvider::TransmitPdcpPduParameters params)
+{
+    Time now = Simulator::Now();
+    uint32_t size = params.pdcpPdu->GetSize();
+    if ((m_maxBytes > 0 && GetBytes(*bearer) + size > m_maxBytes) ||
+        (m_maxPackets > 0 && bearer->sdus.size() >= m_maxPackets))
+    {
+        ++bearer->limitDrops;
+        return;
+    }
+    if (bearer->codel && !bearer->sdus.empty() &&
+        bearer->codel->Drop(now, now - bearer->sdus.front().arrival, GetBytes(*bearer)))
+    {
+        ++bearer->aqmDrops;
+        return;
+    }
+
+    Integrate(bearer, now);
+    bearer->sdus.push_back({now, size});
+    bearer->sduBytes += size;
+    bearer->maxBytes = std::max<uint32_t>(bearer->maxBytes, GetBytes(*bearer));
+    bearer->maxPackets = std::max<uint32_t>(bearer->maxPackets, bearer->sdus.size());
+    ++bearer->admitted;
+    bearer->rlc->TransmitPdcpPdu(params);
+}
+
+void
+RlcQueueManager::Dequeue(Bearer* bearer, const LteMacSapProvider::TransmitPduParameters& params)
+{
+    Time now = Simulator::Now();
+    LteRlcHeader header;
+    params.pdu->PeekHeader(header);
+    uint32_t data = params.pdu->GetSize() - header.GetSerializedSize();
+
+    // RLC UM sends the SDUs in order, the first and last possibly as segments
+    Integrate(bearer, now);
+    while (data > 0 && !bearer->sdus.empty())
+    {
+        const Sdu& head = bearer->sdus.front();
+        uint32_t left = head.size - bearer->headSent;
+        if (data < left)
+        {
+            bearer->headSent += data;
+            break;
+        }
+        data -= left;
+        bearer->sojourn.Add(now - head.arrival);
+        bearer->sduBytes -= head.size;
+        bearer->headSent = 0;
+        bearer->sdus.pop_front();
+    }
+}
+
+void
+RlcQueueManager::BufferStatus(Bearer* bearer, const LteMacSapProvider::ReportBufferStatusParameters& params)
+{
+    // An empty RLC buffer with SDUs left in the mirror means the RLC discarded
+    // them itself; forget them rather than count them as queued forever
+    if (params.txQueueSize == 0 && !bearer->sdus.empty())
+    {
+        Integrate(bearer, Simulator::Now());
+        bearer->sdus.clear();
+        bearer->sduBytes = 0;
+        bearer->headSent = 0;
+    }
+}
+
+double
+RlcQueueManager::GetMeanBytes(const Bearer& bearer) const
+{
+    Time now = Simulator::Now();
+    double duration = (now - m_start).GetSeconds();
+    double byteSeconds = bearer.byteSeconds + GetBytes(bearer) * (now - bearer.lastChange).GetSeconds();
+    return duration > 0 ? byteSeconds / duration : 0;
+}
+
+uint64_t
+RlcQueueManager::GetQueuedPackets() const
+{
+    uint64_t packets = 0;
+    for (const auto& bearer : m_bearers)
+    {
+        packets += bearer->sdus.size();
+    }
+    return packets;
+}
+
+uint64_t
+RlcQueueManager::GetQueuedBytes() const
+{
+    uint64_t bytes = 0;
+    for (const auto& bearer : m_bearers)
+    {
+        bytes += GetBytes(*bearer);
+    }
+    return bytes;
+}
+
+double
+RlcQueueManager::GetDropRate() const
+{
+    uint64_t arrived = 0;
+    uint64_t dropped = 0;
+    for (const auto& bearer : m_bearers)
+    {
+        arrived += bearer->admitted + bearer->limitDrops + bearer->aqmDrops;
+        dropped += bearer->limitDrops + bearer->aqmDrops;
+    }
+    return arrived > 0 ? 100.0 * dropped / arrived : 0;
+}
+
+LatencySketch
+RlcQueueManager::GetSojourn() const
+{
+    LatencySketch sojourn;
+    for (const auto& bearer : m_bearers)
+    {
+        sojourn.Merge(bearer->sojourn);
+    }
+    return sojourn;
+}
+
+void
+RlcQueueManager::Report(std::ostream& os, bool perBearer) const
+{
+    uint64_t limitDrops = 0;
+    uint64_t aqmDrops = 0;
+    uint32_t maxBytes = 0;
+    double meanBytes = 0;
+    for (const auto& bearer : m_bearers)
+    {
+        double bearerMean = GetMeanBytes(*bearer);
+        if (perBearer)
+        {
+            os << "  RLC cell " << bearer->cellId << " RNTI " << bearer->rnti << " LCID " << +bearer->lcid
+               << ": queue mean " << bearerMean << " B, max " << bearer->maxBytes << " B / "
+               << bearer->maxPackets << " SDUs, " << bearer->limitDrops << " limit drops, " << bearer->aqmDrops
+               << " AQM drops\n";
+        }
+        limitDrops += bearer->limitDrops;
+        aqmDrops += bearer->aqmDrops;
+        maxBytes = std::max(maxBytes, bearer->maxBytes);
+        meanBytes += bearerMean;
+    }
+
+    os << "  RLC queue mean/max: " << (m_bearers.empty() ? 0 : meanBytes / m_bearers.size()) << " / " << maxBytes
+       << " B per bearer\n";
+    os << "  RLC drop rate: " << GetDropRate() << " % (" << limitDrops << " limit, " << aqmDrops << " AQM)\n";
+    PrintPercentiles(os, "  RLC sojourn", GetSojourn());
+}
+
+} // namespace ns3
@@ -0,0 +1,179 @@
+#ifndef RLC_QUEUE_MANAGER_H
+#define RLC_QUEUE_MANAGER_H
+
+#include "latency-stats.h"
+
+#include "ns3/lte-mac-sap.h"
+#include "ns3/lte-rlc-sap.h"
+#include "ns3/net-device-container.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class LteEnbRrc;
+
+/**
+ * CoDel control law (Nichols and Jacobson) on the sojourn time of the head
+ * of a queue. Drop() is asked once per arriving packet, with the time the
+ * oldest packet has spent in the queue: once that stayed above Target for a
+ * whole Interval it says to drop, then again after Interval / sqrt(count)
+ * while the sojourn time stays above Target.
+ */
+class CodelController
+{
+  public:
+    CodelController(Time target, Time interval);
+
+    /// Whether the arriving packet should be dropped; queueBytes excludes it
+    bool Drop(Time now, Time sojourn, uint32_t queueBytes);
+
+  private:
+    Time ControlLaw(Time t) const;
+
+    Time m_target;
+    Time m_interval;
+    Time m_firstAboveTime;
+    Time m_dropNext;
+    uint32_t m_count{0};
+    uint32_t m_lastCount{0};
+    bool m_dropping{false};
+};
+
+/**
+ * Bounded downlink RLC UM transmit queues, with optional AQM and cheap
+ * occupancy statistics per bearer.
+ *
+ * LteRlcUm keeps its transmit buffer to itself, so the manager sits on both
+ * sides of the RLC of every data radio bearer of the gNBs, as each is
+ * created: between PDCP and RLC it mirrors the SDUs (size and arrival time)
+ * and drops arriving SDUs over the byte or packet limit or when CoDel says
+ * so; between RLC and MAC it reads the RLC header of every PDU the RLC sends
+ * and retires its data bytes from the head of the mirror, SDU by SDU and
+ * segment by segment, as RLC UM sends them in order. An SDU leaves the
+ * mirror when its last byte is sent, which is its sojourn time, and the
+ * queue size is integrated over time at every arrival and departure.
+ * Nothing is stored per packet beyond the queued SDUs.
+ *
+ * The drop happens at enqueue (the RLC queue cannot be touched at dequeue),
+ * with the CoDel decision made on the sojourn time of the oldest SDU still
+ * (partly) queued.
+ */
+class RlcQueueManager
+{
+  public:
+    /// maxBytes / maxPackets 0 means no limit, aqm is none or codel
+    RlcQueueManager(uint32_t maxBytes, uint32_t maxPackets, const std::string& aqm, Time target, Time interval);
+    ~RlcQueueManager();
+
+    /// Watch the data radio bearers created from now on by these gNBs
+    void Install(const NetDeviceContainer& gnbDevices);
+
+    /// SDUs and SDU bytes not sent yet in the queues now
+    uint64_t GetQueuedPackets() const;
+    uint64_t GetQueuedBytes() const;
+    /// Dropped share of the SDUs that reached the queues, in percent
+    double GetDropRate() const;
+    /// Sojourn time of the SDUs sent, over all bearers
+    LatencySketch GetSojourn() const;
+
+    /// Aggregate statistics, preceded by those of every bearer if perBearer
+    void Report(std::ostream& os, bool perBearer) const;
+
+  private:
+    struct Bearer;
+
+    /// PDCP -> RLC, where SDUs are admitted or dropped
+    class RlcSapProvider : public LteRlcSapProvider
+    {
+      public:
+        RlcSapProvider(RlcQueueManager* manager, Bearer* bearer);
+        void TransmitPdcpPdu(TransmitPdcpPduParameters params) override;
+
+      private:
+        RlcQueueManager* m_manager;
+        Bearer* m_bearer;
+    };
+
+    /// RLC -> MAC, where the sent PDUs retire the mirrored SDUs
+    class MacSapProvider : public LteMacSapProvider
+    {
+      public:
+        MacSapProvider(RlcQueueManager* manager, Bearer* bearer);
+        void TransmitPdu(TransmitPduParameters params) override;
+        void ReportBufferStatus(ReportBufferStatusParameters params) override;
+
+      private:
+        RlcQueueManager* m_manager;
+        Bearer* m_bearer;
+    };
+
+    struct Sdu
+    {
+        Time arrival;
+        uint32_t size;
+    };
+
+    struct Bearer
+    {
+        uint16_t cellId{0};
+        uint16_t rnti{0};
+        uint8_t lcid{0};
+        LteRlcSapProvider* rlc{nullptr};
+        LteMacSapProvider* mac{nullptr};
+        std::unique_ptr<RlcSapProvider> rlcSap;
+        std::unique_ptr<MacSapProvider> macSap;
+        std::unique_ptr<CodelController> codel;
+
+        // Mirror of the RLC transmit buffer: the SDUs, their bytes and the
+        // bytes of the head SDU already sent in segments
+        std::deque<Sdu> sdus;
+        uint64_t sduBytes{0};
+        uint32_t headSent{0};
+        // Time integral of the queued bytes, up to the last change
+        Time lastChange;
+        double byteSeconds{0};
+        uint32_t maxBytes{0};
+        uint32_t maxPackets{0};
+
+        uint64_t admitted{0};
+        uint64_t limitDrops{0};
+        uint64_t aqmDrops{0};
+        LatencySketch sojourn;
+    };
+
+    void DrbCreated(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti, uint8_t lcid);
+    void Enqueue(Bearer* bearer, LteRlcSapProvider::TransmitPdcpPduParameters params);
+    /// Retire the data bytes of a PDU sent by the RLC from the head of the mirror
+    void Dequeue(Bearer* bearer, const LteMacSapProvider::TransmitPduParameters& params);
+    /// Resynchronize the mirror when the RLC reports an empty buffer
+    void BufferStatus(Bearer* bearer, const LteMacSapProvider::ReportBufferStatusParameters& params);
+    /// Bytes of a bearer not sent yet, and their integral up to now
+    static uint64_t GetBytes(const Bearer& bearer);
+    static void Integrate(Bearer* bearer, Time now);
+    /// Time average of the queue size of a bearer since Install, in bytes
+    double GetMeanBytes(const Bearer& bearer) const;
+
+    uint32_t m_maxBytes;
+    uint32_t m_maxPackets;
+    bool m_codel;
+    Time m_target;
+    Time m_interval;
+    Time m_start;
+
+    std::vector<Ptr<LteEnbRrc>> m_rrcs;
+    std::vector<LteMacSapProvider*> m_macs;
+    std::vector<std::unique_ptr<Bearer>> m_bearers;
+};
+
+} // namespace ns3
+
+#endif // RLC_QUEUE_MANAGER_H
@@ -0,0 +1,265 @@
+#include "run-length-controller.h"
+
+#include "replication-report.h"
+
+#include "ns3/abort.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+namespace
+{
+
+// MSER-5 truncation point: the number of leading observations whose removal
+// minimises the standard error of the mean of the rest, searched over the
+// first half of the series in steps of 5
+std::size_t
+MserTruncation(const std::vector<double>& values)
+{
+    const std::size_t step = 5;
+    std::size_t groups = values.size() / step;
+    if (groups < 2)
+    {
+        return 0;
+    }
+    std::vector<double> means(groups);
+    for (std::size_t j = 0; j < groups; ++j)
+    {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < step; ++i)
+        {
+            sum += values[j * step + i];
+        }
+        means[j] = sum / step;
+    }
+
+    // Suffix sums give the statistic of every truncation point in O(n)
+    double sum = 0.0;
+    double squares = 0.0;
+    double best = INFINITY;
+    std::size_t bestGroups = 0;
+    for (std::size_t d = groups; d-- > 0;)
+    {
+        sum += means[d];
+        squares += means[d] * means[d];
+        std::size_t kept = groups - d;
+        if (d <= groups / 2 && kept > 1)
+        {
+            double statistic = (squares - sum * sum / kept) / (kept * kept);
+            if (statistic <= best)
+            {
+                best = statistic;
+                bestGroups = d;
+            }
+        }
+    }
+    return bestGroups * step;
+}
+
+// Lag-1 autocorrelation of a series
+double
+Lag1Autocorrelation(const std::vector<double>& values)
+{
+    double mean = 0.0;
+    for (double value : values)
+    {
+        mean += value;
+    }
+    mean /= values.size();
+    double covariance = 0.0;
+    double variance = 0.0;
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        variance += (values[i] - mean) * (values[i] - mean);
+        if (i > 0)
+        {
+            covariance += (values[i] - mean) * (values[i - 1] - mean);
+        }
+    }
+    return variance > 0 ? covariance / variance : 0.0;
+}
+
+} // namespace
+
+RunLengthController::RunLengthController(double relativePrecision,
+                                         Time minTime,
+                                         uint32_t batches,
+                                         uint32_t minBatches,
+                                         uint32_t minBatchSize)
+    : m_relativePrecision(relativePrecision),
+      m_minTime(minTime),
+      m_batches(batches),
+      m_minBatches(minBatches),
+      m_minBatchSize(minBatchSize)
+{
+    NS_ABORT_MSG_IF(minBatches < 2 || minBatches > batches || minBatchSize == 0,
+                    "The run length needs 2 <= minBatches <= batches and a positive batch size");
+}
+
+void
+RunLengthController::Attach(KpiSampler& sampler)
+{
+    sampler.SetSampleCallback([this](const KpiSampler::FlowSample& sample) { Sample(sample); });
+    sampler.SetTickCallback([this](Time now) { Tick(now); });
+}
+
+bool
+RunLengthController::HasConverged() const
+{
+    return m_converged;
+}
+
+Time
+RunLengthController::GetRunLength() const
+{
+    return m_lastTick;
+}
+
+Time
+RunLengthController::GetWarmupEnd() const
+{
+    auto series = Estimate();
+    return Seconds(std::max(series.first.GetWarmupEnd(), series.second.GetWarmupEnd()));
+}
+
+double
+RunLengthController::GetSteadyThroughput() const
+{
+    return Estimate().first.mean;
+}
+
+double
+RunLengthController::GetSteadyDelay() const
+{
+    return Estimate().second.mean;
+}
+
+void
+RunLengthController::Sample(const KpiSampler::FlowSample& sample)
+{
+    uint64_t& last = m_lastRxPackets[sample.flowId];
+    uint64_t rxPackets = sample.rxPackets - last;
+    last = sample.rxPackets;
+
+    m_throughput += sample.throughputMbps;
+    m_delaySum += sample.meanDelayMs * rxPackets;
+    m_rxPackets += rxPackets;
+}
+
+void
+RunLengthController::Tick(Time now)
+{
+    m_lastTick = now;
+    m_throughputSeries.values.push_back(m_throughput);
+    m_throughputSeries.times.push_back(now);
+    if (m_rxPackets > 0)
+    {
+        m_delaySeries.values.push_back(m_delaySum / m_rxPackets);
+        m_delaySeries.times.push_back(now);
+    }
+    m_throughput = 0.0;
+    m_delaySum = 0.0;
+    m_rxPackets = 0;
+
+    if (m_converged || now < m_minTime)
+    {
+        return;
+    }
+    bool throughputConverged = m_throughputSeries.Update(*this);
+    bool delayConverged = m_delaySeries.Update(*this);
+    if (throughputConverged && delayConverged)
+    {
+        m_converged = true;
+        Simulator::Stop();
+    }
+}
+
+bool
+RunLengthController::Series::Update(const RunLengthController& controller)
+{
+    warmup = MserTruncation(values);
+    std::size_t kept = values.size() - warmup;
+    batchSize = std::max<std::size_t>(controller.m_minBatchSize, kept / controller.m_batches);
+    batchCount = 0;
+
+    // Consecutive ticks are correlated: grow the batches until their means
+    // look independent (|r1| within the 95% bound of white noise)
+    std::vector<double> batchMeans;
+    while (kept / batchSize >= controller.m_minBatches)
+    {
+        batchCount = std::min<std::size_t>(kept / batchSize, controller.m_batches);
+
+        // Batches are taken from the end so that the oldest leftovers are dropped
+        batchMeans.assign(batchCount, 0.0);
+        std::size_t first = values.size() - batchSize * batchCount;
+        for (std::size_t b = 0; b < batchCount; ++b)
+        {
+            double sum = 0.0;
+            for (std::size_t i = 0; i < batchSize; ++i)
+            {
+                sum += values[first + b * batchSize + i];
+            }
+            batchMeans[b] = sum / batchSize;
+        }
+        if (std::abs(Lag1Autocorrelation(batchMeans)) * std::sqrt(batchCount) <= 1.96)
+        {
+            break;
+        }
+        batchMeans.clear();
+        batchSize *= 2;
+    }
+
+    // Not enough independent batches yet: report the plain mean of the kept samples
+    if (batchMeans.empty())
+    {
+        batchCount = 0;
+        std::vector<double> rest(values.begin() + warmup, values.end());
+        mean = ReplicationReport::ConfidenceInterval(rest).first;
+        halfWidth = INFINITY;
+        return false;
+    }
+    auto ci = ReplicationReport::ConfidenceInterval(batchMeans);
+    mean = ci.first;
+    halfWidth = ci.second;
+    return mean != 0.0 && halfWidth <= controller.m_relativePrecision * std::abs(mean);
+}
+
+double
+RunLengthController::Series::GetWarmupEnd() const
+{
+    return warmup < times.size() ? times[warmup].GetSeconds() : 0.0;
+}
+
+std::pair<RunLengthController::Series, RunLengthController::Series>
+RunLengthController::Estimate() const
+{
+    // Estimates over the whole run, also when it never got past the minimum time
+    std::pair<Series, Series> series(m_throughputSeries, m_delaySeries);
+    series.first.Update(*this);
+    series.second.Update(*this);
+    return series;
+}
+
+void
+RunLengthController::Report(std::ostream& os) const
+{
+    auto series = Estimate();
+    const Series& throughput = series.first;
+    const Series& delay = series.second;
+
+    os << "\n  Run length: " << m_lastTick.GetSeconds() << " s, "
+       << (m_converged ? "converged" : "target precision not reached") << "\n";
+    os << "  Warm-up: " << throughput.GetWarmupEnd() << " s (throughput), " << delay.GetWarmupEnd()
+       << " s (delay)\n";
+    os << "  Batches: " << throughput.batchCount << " x " << throughput.batchSize << " ticks (throughput), "
+       << delay.batchCount << " x " << delay.batchSize << " ticks (delay)\n";
+    os << "  Steady state throughput: " << throughput.mean << " +/- " << throughput.halfWidth
+       << " Mbps\n";
+    os << "  Steady state delay: " << delay.mean << " +/- " << delay.halfWidth << " ms\n";
+}
+
+} // namespace ns3
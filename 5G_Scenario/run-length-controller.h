@@ -0,0 +1,98 @@
+#ifndef RUN_LENGTH_CONTROLLER_H
+#define RUN_LENGTH_CONTROLLER_H
+
+#include "kpi-sampler.h"
+
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Sequential stopping rule on the KPI time series.
+ *
+ * On every KpiSampler tick it appends the aggregate throughput and the
+ * packet weighted mean delay of the interval to two series. Once past the
+ * minimum time it drops the warm-up of each series (MSER-5) and splits the
+ * rest into at most `batches` batches of at least `minBatchSize` ticks. The
+ * batch size is doubled while the lag-1 autocorrelation of the batch means is
+ * significant, and the 95% confidence interval of the batch means is only
+ * trusted with at least `minBatches` of them. When the half width of both is
+ * below the target fraction of their mean it calls Simulator::Stop();
+ * otherwise the run ends at simTime as usual.
+ */
+class RunLengthController
+{
+  public:
+    RunLengthController(double relativePrecision,
+                        Time minTime,
+                        uint32_t batches = 20,
+                        uint32_t minBatches = 10,
+                        uint32_t minBatchSize = 10);
+
+    /// Take the samples and ticks of the sampler
+    void Attach(KpiSampler& sampler);
+
+    bool HasConverged() const;
+
+    /// Time of the last tick, where the run stopped if it converged
+    Time GetRunLength() const;
+    /// End of the longer of the two warm-ups
+    Time GetWarmupEnd() const;
+    /// Steady state means, without the warm-up, in Mbps and ms
+    double GetSteadyThroughput() const;
+    double GetSteadyDelay() const;
+
+    /// Print the run length, warm-up and steady state estimates
+    void Report(std::ostream& os) const;
+
+  private:
+    struct Series
+    {
+        std::vector<double> values;
+        std::vector<Time> times;
+        std::size_t warmup{0};
+        std::size_t batchSize{0};
+        std::size_t batchCount{0};
+        double mean{0.0};
+        double halfWidth{0.0};
+
+        /// Recompute warm-up and batch means, true if the target precision is met
+        bool Update(const RunLengthController& controller);
+        /// End of the warm-up in seconds
+        double GetWarmupEnd() const;
+    };
+
+    /// Both series updated with all their samples
+    std::pair<Series, Series> Estimate() const;
+
+    void Sample(const KpiSampler::FlowSample& sample);
+    void Tick(Time now);
+
+    double m_relativePrecision;
+    Time m_minTime;
+    uint32_t m_batches;
+    uint32_t m_minBatches;
+    uint32_t m_minBatchSize;
+    bool m_converged{false};
+    Time m_lastTick;
+
+    // Accumulated over the flows of the current tick
+    double m_throughput{0.0};
+    double m_delaySum{0.0};
+    uint64_t m_rxPackets{0};
+    std::map<FlowId, uint64_t> m_lastRxPackets;
+
+    Series m_throughputSeries;
+    Series m_delaySeries;
+};
+
+} // namespace ns3
+
+#endif // RUN_LENGTH_CONTROLLER_H
@@ -0,0 +1,180 @@
+#include "run-profile.h"
+
+#include "ns3/abort.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+
+#include <sys/resource.h>
+
+namespace ns3
+{
+
+RunProfile::RunProfile(const std::string& name)
+    : m_created(Clock::now())
+{
+    if (name == "debug")
+    {
+        m_mode = DEBUG;
+    }
+    else if (name == "measurement")
+    {
+        m_mode = MEASUREMENT;
+    }
+    else if (name == "fast")
+    {
+        m_mode = FAST;
+    }
+    else
+    {
+        NS_ABORT_MSG("Unknown run profile " << name << " (expected debug, measurement or fast)");
+    }
+    m_runStart = m_created;
+    m_runEnd = m_created;
+}
+
+RunProfile::Mode
+RunProfile::GetMode() const
+{
+    return m_mode;
+}
+
+std::string
+RunProfile::GetName() const
+{
+    switch (m_mode)
+    {
+    case DEBUG:
+        return "debug";
+    case MEASUREMENT:
+        return "measurement";
+    case FAST:
+        return "fast";
+    }
+    return "unknown";
+}
+
+bool
+RunProfile::IsPacketMetadataEnabled() const
+{
+    return m_mode == DEBUG;
+}
+
+bool
+RunProfile::IsAnimationEnabled() const
+{
+    return m_mode != FAST;
+}
+
+bool
+RunProfile::IsAnimationPacketMetadataEnabled() const
+{
+    return m_mode == DEBUG;
+}
+
+void
+RunProfile::ApplyPacketSettings() const
+{
+    if (IsPacketMetadataEnabled())
+    {
+        Packet::EnableChecking();
+        Packet::EnablePrinting();
+    }
+}
+
+void
+RunProfile::BeginPhase(const std::string& name)
+{
+    Clock::time_point now = Clock::now();
+    if (!m_phases.empty())
+    {
+        m_phases.back().second = std::chrono::duration<double>(now - m_phaseStart).count();
+    }
+    m_phases.emplace_back(name, 0.0);
+    m_phaseStart = now;
+}
+
+const std::vector<std::pair<std::string, double>>&
+RunProfile::GetPhases() const
+{
+    return m_phases;
+}
+
+void
+RunProfile::StartRun()
+{
+    m_runStart = Clock::now();
+    if (!m_phases.empty())
+    {
+        m_phases.back().second = std::chrono::duration<double>(m_runStart - m_phaseStart).count();
+    }
+    m_eventsAtStart = Simulator::GetEventCount();
+}
+
+void
+RunProfile::StopRun()
+{
+    m_runEnd = Clock::now();
+    m_events = Simulator::GetEventCount() - m_eventsAtStart;
+}
+
+void
+RunProfile::ExcludeFromRun(double seconds)
+{
+    m_excludedSeconds += seconds;
+}
+
+double
+RunProfile::GetSetupSeconds() const
+{
+    return std::chrono::duration<double>(m_runStart - m_created).count();
+}
+
+double
+RunProfile::GetRunSeconds() const
+{
+    return std::chrono::duration<double>(m_runEnd - m_runStart).count() - m_excludedSeconds;
+}
+
+uint64_t
+RunProfile::GetEvents() const
+{
+    return m_events;
+}
+
+double
+RunProfile::GetEventsPerSecond() const
+{
+    double seconds = GetRunSeconds();
+    return seconds > 0 ? m_events / seconds : 0.0;
+}
+
+double
+RunProfile::GetPeakRssMiB() const
+{
+    // ru_maxrss is in KiB on Linux
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;
+}
+
+void
+RunProfile::Report(std::ostream& os) const
+{
+    os << "\n  Run profile: " << GetName() << "\n";
+    os << "  Setup wall time: " << GetSetupSeconds() << " s\n";
+    for (const auto& phase : m_phases)
+    {
+        os << "  Setup phase " << phase.first << ": " << phase.second << " s\n";
+    }
+    os << "  Run wall time: " << GetRunSeconds() << " s";
+    if (m_excludedSeconds > 0)
+    {
+        os << " (" << m_excludedSeconds << " s of memory sampling excluded)";
+    }
+    os << "\n";
+    os << "  Events processed: " << GetEvents() << "\n";
+    os << "  Events per second: " << GetEventsPerSecond() << "\n";
+    os << "  Peak RSS: " << GetPeakRssMiB() << " MiB\n";
+}
+
+} // namespace ns3
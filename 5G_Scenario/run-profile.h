@@ -0,0 +1,88 @@
+#ifndef RUN_PROFILE_H
+#define RUN_PROFILE_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Groups the debug features that sit on the per-packet hot path so that
+ * they can be turned off together, and measures how fast the run was.
+ *
+ * - debug: packet checking and printing, NetAnim with packet metadata
+ *   (the behaviour of the original scenarios)
+ * - measurement: no packet metadata, NetAnim without packet metadata
+ * - fast: no packet metadata and no NetAnim at all
+ */
+class RunProfile
+{
+  public:
+    enum Mode
+    {
+        DEBUG,
+        MEASUREMENT,
+        FAST
+    };
+
+    /// Build the profile from its name, aborting on unknown names
+    explicit RunProfile(const std::string& name);
+
+    Mode GetMode() const;
+    std::string GetName() const;
+
+    /// Whether Packet::EnableChecking() and Packet::EnablePrinting() are called
+    bool IsPacketMetadataEnabled() const;
+    /// Whether an AnimationInterface is created
+    bool IsAnimationEnabled() const;
+    /// Whether the AnimationInterface records per-packet metadata
+    bool IsAnimationPacketMetadataEnabled() const;
+
+    /// Enable packet checking and printing if the profile asks for them
+    void ApplyPacketSettings() const;
+
+    /// End the current setup phase, if any, and start timing the next one
+    void BeginPhase(const std::string& name);
+    /// Setup phases in order, with their wall time in seconds
+    const std::vector<std::pair<std::string, double>>& GetPhases() const;
+
+    /// Mark the end of the scenario construction (and of its last phase) and the start of Simulator::Run()
+    void StartRun();
+    /// Mark the end of Simulator::Run()
+    void StopRun();
+    /// Take the wall time of instrumentation run as simulator events (memory
+    /// samples) out of the run wall time and the event rate
+    void ExcludeFromRun(double seconds);
+
+    double GetSetupSeconds() const;
+    double GetRunSeconds() const;
+    uint64_t GetEvents() const;
+    double GetEventsPerSecond() const;
+    /// Peak resident set size of the process so far, in MiB
+    double GetPeakRssMiB() const;
+
+    /// Print wall times (setup phase by phase), event rate and peak memory of the run
+    void Report(std::ostream& os) const;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    Mode m_mode;
+    Clock::time_point m_created;
+    Clock::time_point m_phaseStart;
+    std::vector<std::pair<std::string, double>> m_phases;
+    Clock::time_point m_runStart;
+    Clock::time_point m_runEnd;
+    uint64_t m_eventsAtStart{0};
+    uint64_t m_events{0};
+    double m_excludedSeconds{0.0};
+};
+
+} // namespace ns3
+
+#endif // RUN_PROFILE_H
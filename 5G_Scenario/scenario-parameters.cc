@@ -0,0 +1,340 @@
+#include "scenario-parameters.h"
+
+#include "ns3/abort.h"
+
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+namespace ns3
+{
+
+void
+ScenarioParameters::ApplyTrafficPreset(const std::string& name)
+{
+    traffic = name;
+    if (name == "voice")
+    {
+        udpPacketSizeBe = 1024;
+        numerologyBwp1 = 4;
+        bandwidthBand1 = 100e6;
+        bandwidthBand2 = 100e6;
+        bearer = "GBR_CONV_VOICE";
+        dlPort = 1235;
+    }
+    else if (name == "lowlatency")
+    {
+        udpPacketSizeBe = 512;  // Smaller packet size for low latency
+        numerologyBwp1 = 3;     // Adjusted numerology for low latency
+        bandwidthBand1 = 400e6; // Increased bandwidth
+        bandwidthBand2 = 400e6;
+        bearer = "NGBR_LOW_LAT_EMBB";
+        dlPort = 1236;
+    }
+    else
+    {
+        NS_ABORT_MSG("Unknown traffic preset " << name << " (expected voice or lowlatency)");
+    }
+}
+
+void
+ScenarioParameters::AddToCommandLine(CommandLine& cmd)
+{
+    cmd.AddValue("traffic", "Traffic model preset: voice or lowlatency", traffic);
+    cmd.AddValue("gNbNum", "Number of gNBs", gNbNum);
+    cmd.AddValue("ueNum", "Number of UEs", ueNum);
+    cmd.AddValue("gNbLayout", "Placement of the gNBs: row or grid", gNbLayout);
+    cmd.AddValue("gNbSpacing", "Distance between neighbouring gNBs in meters", gNbSpacing);
+    cmd.AddValue("attach", "UE attachment: alternate (UE i to gNB i % gNbNum) or closest", attach);
+    cmd.AddValue("logging", "Enable logging", logging);
+    cmd.AddValue("doubleOperationalBand",
+                 "If true, simulate two operational bands with one CC each",
+                 doubleOperationalBand);
+    cmd.AddValue("udpPacketSizeBe", "UDP packet size in bytes", udpPacketSizeBe);
+    cmd.AddValue("lambdaBe", "UDP rate parameter, packets are sent every 5000 / lambdaBe seconds", lambdaBe);
+    cmd.AddValue("source",
+                 "Downlink traffic source: udp (UdpClient per UE), mux (one multiplexed client for all the UEs), "
+                 "trace (replay of --traceFile), voip (talkspurt/silence codec model) or urllc (bursts with a "
+                 "delivery deadline)",
+                 source);
+    cmd.AddValue("voipCodec", "Frame sizes of the voip source: amr-nb, amr-wb or evs", voipCodec);
+    cmd.AddValue("traceFile", "Packet trace replayed by the trace source: \"time,size,flow\" lines or pcap", traceFile);
+    cmd.AddValue("traceFormat", "Format of the trace file: auto, text or pcap", traceFormat);
+    cmd.AddValue("urllcArrival", "Arrivals of the urllc bursts: poisson or periodic", urllcArrival);
+    cmd.AddValue("urllcPacketSize", "UDP payload of the urllc packets, in bytes (at least 20)", urllcPacketSize);
+    cmd.AddValue("urllcBurstSize", "Packets per urllc burst", urllcBurstSize);
+    cmd.AddValue("urllcInterval", "Mean time between urllc bursts, in ms", urllcInterval);
+    cmd.AddValue("urllcDeadline", "Delivery budget of every urllc packet, in ms", urllcDeadline);
+    cmd.AddValue("simTime", "Simulation time in seconds", simTime);
+    cmd.AddValue("udpAppStartTime", "Start time of the UDP applications in seconds", udpAppStartTime);
+    cmd.AddValue("numerologyBwp1", "Numerology of the first bandwidth part", numerologyBwp1);
+    cmd.AddValue("centralFrequencyBand1", "Central frequency of the first band in Hz", centralFrequencyBand1);
+    cmd.AddValue("bandwidthBand1", "Bandwidth of the first band in Hz", bandwidthBand1);
+    cmd.AddValue("numerologyBwp2", "Numerology of the second bandwidth part", numerologyBwp2);
+    cmd.AddValue("centralFrequencyBand2", "Central frequency of the second band in Hz", centralFrequencyBand2);
+    cmd.AddValue("bandwidthBand2", "Bandwidth of the second band in Hz", bandwidthBand2);
+    cmd.AddValue("totalTxPower", "Total transmission power", totalTxPower);
+    cmd.AddValue("scheduler",
+                 "MAC scheduler: PF, RR, IndexedPF, Edf, Mlwdf, OfdmaPF, ... or a full TypeId such as ns3::NrMacSchedulerTdmaPF",
+                 scheduler);
+    cmd.AddValue("bearer", "QCI of the dedicated bearer, e.g. GBR_CONV_VOICE", bearer);
+    cmd.AddValue("dlPort", "Downlink UDP port (also used by the TFT packet filter)", dlPort);
+    cmd.AddValue("rlcMaxBytes", "Limit of every downlink RLC queue in bytes (0 = unbounded)", rlcMaxBytes);
+    cmd.AddValue("rlcMaxPackets", "Limit of every downlink RLC queue in SDUs (0 = unbounded)", rlcMaxPackets);
+    cmd.AddValue("rlcAqm", "AQM of the downlink RLC queues: none or codel", rlcAqm);
+    cmd.AddValue("rlcAqmTarget", "CoDel target sojourn time in ms", rlcAqmTarget);
+    cmd.AddValue("rlcAqmInterval", "CoDel interval in ms", rlcAqmInterval);
+    cmd.AddValue("rlcQueueStats", "Print the occupancy, drops and sojourn time of the RLC queues", rlcQueueStats);
+    cmd.AddValue("beamAngleThreshold",
+                 "Recompute the beams of a gNB/UE pair once its direction changed by this many degrees "
+                 "(0 = every beamforming period)",
+                 beamAngleThreshold);
+    cmd.AddValue("beamStats",
+                 "Count and time the beamforming calls also without --beamAngleThreshold (baseline of its saving)",
+                 beamStats);
+    cmd.AddValue("channelUpdatePeriod",
+                 "Regenerate the 3GPP channel of every gNB/UE pair this often, in ms (0 = once per pair)",
+                 channelUpdatePeriod);
+    cmd.AddValue("channelCacheDistance",
+                 "Regenerate the channel of a gNB/UE pair once one end moved this many meters (0 = no cache)",
+                 channelCacheDistance);
+    cmd.AddValue("channelCacheCoherenceTime",
+                 "Regenerate cached channels older than this many seconds (0 = no limit)",
+                 channelCacheCoherenceTime);
+    cmd.AddValue("channelCacheCheck",
+                 "Compare sampled reused channels with freshly generated ones and print the gain error",
+                 channelCacheCheck);
+    cmd.AddValue("channelStats",
+                 "Count the channel matrix generations and their wall time without the cache (baseline of "
+                 "--channelCacheDistance)",
+                 channelStats);
+    cmd.AddValue("delayBinWidth", "Bin width of the FlowMonitor delay and jitter histograms in seconds", delayBinWidth);
+    cmd.AddValue("packetDelay",
+                 "Measure the delay and jitter of every packet at the UDP servers (App throughput/delay and "
+                 "Packet delay/jitter percentiles)",
+                 packetDelay);
+    cmd.AddValue("latencyPrecision", "Relative error of the per-packet delay and jitter percentiles", latencyPrecision);
+    cmd.AddValue("kpiInterval", "Period of the per-flow KPI time series in seconds (0 = disabled)", kpiInterval);
+    cmd.AddValue("kpiCsv",
+                 "Also export the KPI (and memory and MAC slot) time series as CSV at the end of the run",
+                 kpiCsv);
+    cmd.AddValue("macSlotStats",
+                 "Collect per slot RB/symbol use, scheduled UEs and MCS of every gNB carrier, exported at the end",
+                 macSlotStats);
+    cmd.AddValue("macSlotStatsSlots", "Slots kept per carrier by --macSlotStats (ring buffer)", macSlotStatsSlots);
+    cmd.AddValue("linkQuality",
+                 "Print the SINR, wideband/subband CQI and MCS percentiles of every UE with its flow",
+                 linkQuality);
+    cmd.AddValue("targetPrecision",
+                 "Stop when the relative 95% CI half width of throughput and delay is below this "
+                 "(0 = always run for simTime)",
+                 targetPrecision);
+    cmd.AddValue("minSimTime", "Minimum simulation time in seconds with --targetPrecision", minSimTime);
+    cmd.AddValue("p2pDelay", "Delay of the PGW - remote host link in seconds", p2pDelay);
+    cmd.AddValue("distributed",
+                 "Run the remote host on MPI rank 1 (mpirun -np 2), p2pDelay is the lookahead",
+                 distributed);
+    cmd.AddValue("profile",
+                 "Run profile: debug (packet metadata and NetAnim), measurement (NetAnim "
+                 "without packet metadata) or fast (neither)",
+                 profile);
+    cmd.AddValue("eventProfile",
+                 "Print the events and wall time of each event source (PHY, MAC, channel, ...) after the run",
+                 eventProfile);
+    cmd.AddValue("memoryInterval",
+                 "Sample the memory accounting (heap, RSS, live objects, queued packets, FlowMonitor state) every "
+                 "this many seconds (0 = only at the end of the run)",
+                 memoryInterval);
+    cmd.AddValue("animFormat", "Animation output: xml (NetAnim) or binary (compact trace)", animFormat);
+    cmd.AddValue("animStart", "Start of the recorded animation window in seconds", animStart);
+    cmd.AddValue("animStop", "End of the recorded animation window in seconds (0 = simTime)", animStop);
+    cmd.AddValue("animSampling", "Record one packet out of N in the binary animation trace", animSampling);
+    cmd.AddValue("animPollInterval", "Interval between node position updates in seconds", animPollInterval);
+    cmd.AddValue("simTag",
+                 "Tag prepended to every output file name (default traffic-scheduler[-source], e.g. voice-PF)",
+                 simTag);
+    cmd.AddValue("outputDir", "Directory where the output files are stored", outputDir);
+    cmd.AddValue("results",
+                 "Append one record per flow and one per run, tagged with every parameter, to "
+                 "outputDir/resultsTag-results.jsonl (jsonl) or -flows.csv and -runs.csv (csv); none disables it",
+                 results);
+    cmd.AddValue("resultsTag", "Name of the results files, shared by runs (default simTag)", resultsTag);
+    cmd.AddValue("runRecord",
+                 "Also write the run record, without the parameters, as a two line CSV to this file (used by the "
+                 "sweeps to merge their points)",
+                 runRecord);
+}
+
+std::vector<std::pair<std::string, std::string>>
+ScenarioParameters::GetValues() const
+{
+    std::vector<std::pair<std::string, std::string>> values;
+    auto add = [&values](const std::string& name, const auto& value) {
+        std::ostringstream text;
+        text << std::boolalpha << std::setprecision(12) << value;
+        values.emplace_back(name, text.str());
+    };
+    add("traffic", traffic);
+    add("gNbNum", gNbNum);
+    add("ueNum", ueNum);
+    add("gNbLayout", gNbLayout);
+    add("gNbSpacing", gNbSpacing);
+    add("attach", attach);
+    add("logging", logging);
+    add("doubleOperationalBand", doubleOperationalBand);
+    add("udpPacketSizeBe", udpPacketSizeBe);
+    add("lambdaBe", lambdaBe);
+    add("source", source);
+    add("voipCodec", voipCodec);
+    add("traceFile", traceFile);
+    add("traceFormat", traceFormat);
+    add("urllcArrival", urllcArrival);
+    add("urllcPacketSize", urllcPacketSize);
+    add("urllcBurstSize", urllcBurstSize);
+    add("urllcInterval", urllcInterval);
+    add("urllcDeadline", urllcDeadline);
+    add("simTime", simTime);
+    add("udpAppStartTime", udpAppStartTime);
+    add("numerologyBwp1", numerologyBwp1);
+    add("centralFrequencyBand1", centralFrequencyBand1);
+    add("bandwidthBand1", bandwidthBand1);
+    add("numerologyBwp2", numerologyBwp2);
+    add("centralFrequencyBand2", centralFrequencyBand2);
+    add("bandwidthBand2", bandwidthBand2);
+    add("totalTxPower", totalTxPower);
+    add("scheduler", scheduler);
+    add("bearer", bearer);
+    add("dlPort", dlPort);
+    add("rlcMaxBytes", rlcMaxBytes);
+    add("rlcMaxPackets", rlcMaxPackets);
+    add("rlcAqm", rlcAqm);
+    add("rlcAqmTarget", rlcAqmTarget);
+    add("rlcAqmInterval", rlcAqmInterval);
+    add("rlcQueueStats", rlcQueueStats);
+    add("beamAngleThreshold", beamAngleThreshold);
+    add("beamStats", beamStats);
+    add("channelUpdatePeriod", channelUpdatePeriod);
+    add("channelCacheDistance", channelCacheDistance);
+    add("channelCacheCoherenceTime", channelCacheCoherenceTime);
+    add("channelCacheCheck", channelCacheCheck);
+    add("channelStats", channelStats);
+    add("delayBinWidth", delayBinWidth);
+    add("packetDelay", packetDelay);
+    add("latencyPrecision", latencyPrecision);
+    add("kpiInterval", kpiInterval);
+    add("kpiCsv", kpiCsv);
+    add("macSlotStats", macSlotStats);
+    add("macSlotStatsSlots", macSlotStatsSlots);
+    add("linkQuality", linkQuality);
+    add("targetPrecision", targetPrecision);
+    add("minSimTime", minSimTime);
+    add("p2pDelay", p2pDelay);
+    add("distributed", distributed);
+    add("profile", profile);
+    add("eventProfile", eventProfile);
+    add("memoryInterval", memoryInterval);
+    add("animFormat", animFormat);
+    add("animStart", animStart);
+    add("animStop", animStop);
+    add("animSampling", animSampling);
+    add("animPollInterval", animPollInterval);
+    add("simTag", simTag);
+    add("outputDir", outputDir);
+    add("results", results);
+    add("resultsTag", resultsTag);
+    add("runRecord", runRecord);
+    return values;
+}
+
+std::string
+ScenarioParameters::GetSchedulerTypeName() const
+{
+    return GetSchedulerTypeName(scheduler);
+}
+
+std::string
+ScenarioParameters::GetSchedulerTypeName(const std::string& scheduler)
+{
+    if (scheduler.find("::") != std::string::npos)
+    {
+        return scheduler;
+    }
+    if (scheduler.rfind("Tdma", 0) == 0 || scheduler.rfind("Ofdma", 0) == 0)
+    {
+        return "ns3::NrMacScheduler" + scheduler;
+    }
+    return "ns3::NrMacSchedulerTdma" + scheduler;
+}
+
+EpsBearer::Qci
+ScenarioParameters::GetBearerQci() const
+{
+    static const std::map<std::string, EpsBearer::Qci> qciByName = {
+        {"GBR_CONV_VOICE", EpsBearer::GBR_CONV_VOICE},
+        {"GBR_CONV_VIDEO", EpsBearer::GBR_CONV_VIDEO},
+        {"GBR_GAMING", EpsBearer::GBR_GAMING},
+        {"GBR_NON_CONV_VIDEO", EpsBearer::GBR_NON_CONV_VIDEO},
+        {"NGBR_IMS", EpsBearer::NGBR_IMS},
+        {"NGBR_VIDEO_TCP_OPERATOR", EpsBearer::NGBR_VIDEO_TCP_OPERATOR},
+        {"NGBR_VOICE_VIDEO_GAMING", EpsBearer::NGBR_VOICE_VIDEO_GAMING},
+        {"NGBR_VIDEO_TCP_PREMIUM", EpsBearer::NGBR_VIDEO_TCP_PREMIUM},
+        {"NGBR_VIDEO_TCP_DEFAULT", EpsBearer::NGBR_VIDEO_TCP_DEFAULT},
+        {"NGBR_LOW_LAT_EMBB", EpsBearer::NGBR_LOW_LAT_EMBB},
+    };
+    auto it = qciByName.find(bearer);
+    NS_ABORT_MSG_IF(it == qciByName.end(), "Unknown bearer " << bearer);
+    return it->second;
+}
+
+std::string
+ScenarioParameters::GetDefaultSimTag() const
+{
+    // Short name of a scheduler given as a TypeId, e.g. ns3::NrMacSchedulerTdmaPF -> TdmaPF
+    std::string name = scheduler.substr(scheduler.rfind(':') == std::string::npos ? 0 : scheduler.rfind(':') + 1);
+    const std::string prefix = "NrMacScheduler";
+    if (name.rfind(prefix, 0) == 0)
+    {
+        name = name.substr(prefix.size());
+    }
+    return traffic + "-" + name + (source == "udp" ? "" : "-" + source);
+}
+
+std::string
+ScenarioParameters::GetOutputPath(const std::string& suffix) const
+{
+    std::string dir = outputDir;
+    if (!dir.empty() && dir.back() != '/')
+    {
+        dir += '/';
+    }
+    return dir + simTag + suffix;
+}
+
+std::string
+ScenarioParameters::GetResultsPrefix() const
+{
+    std::string dir = GetOutputPath("");
+    dir.resize(dir.size() - simTag.size());
+    return dir + (resultsTag.empty() ? simTag : resultsTag);
+}
+
+std::string
+ScenarioParameters::FindArgument(int argc,
+                                 char* argv[],
+                                 const std::string& name,
+                                 const std::string& defaultValue)
+{
+    const std::string prefix = "--" + name + "=";
+    std::string value = defaultValue;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg.rfind(prefix, 0) == 0)
+        {
+            value = arg.substr(prefix.size());
+        }
+    }
+    return value;
+}
+
+} // namespace ns3
@@ -0,0 +1,198 @@
+#ifndef SCENARIO_PARAMETERS_H
+#define SCENARIO_PARAMETERS_H
+
+#include "ns3/command-line.h"
+#include "ns3/eps-bearer.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * All the knobs of the 5G scenario. The defaults reproduce the original
+ * voice traffic model; ApplyTrafficPreset() switches to the low latency one.
+ */
+struct ScenarioParameters
+{
+    std::string traffic = "voice"; // Traffic model preset (voice or lowlatency)
+
+    uint16_t gNbNum = 3; // Number of gNBs
+    uint16_t ueNum = 5;  // Number of UEs
+    // gNB placement (row or grid) and distance between neighbouring gNBs in m
+    std::string gNbLayout = "row";
+    double gNbSpacing = 20.0;
+    // UE attachment: alternate between the gNBs or pick the closest one
+    std::string attach = "alternate";
+    bool logging = false;
+    bool doubleOperationalBand = true;
+
+    // UDP packet size and data rate
+    uint32_t udpPacketSizeBe = 1024;
+    uint32_t lambdaBe = 10000;
+
+    // Downlink source: udp (UdpClient, size and rate above), mux (the same
+    // flows from one MultiplexedUdpClient), trace (TraceReplayClient replay of
+    // traceFile), voip (VoipSource talkspurt/silence model with the frame
+    // sizes of voipCodec) or urllc (UrllcSource bursts with a deadline per packet)
+    std::string source = "udp";
+    std::string voipCodec = "amr-wb";
+    std::string traceFile;
+    std::string traceFormat = "auto";
+
+    // URLLC bursts: poisson or periodic arrivals of urllcBurstSize packets of
+    // urllcPacketSize bytes every urllcInterval ms (mean), urllcDeadline ms budget
+    std::string urllcArrival = "poisson";
+    uint32_t urllcPacketSize = 32;
+    uint32_t urllcBurstSize = 1;
+    double urllcInterval = 10.0;
+    double urllcDeadline = 1.0;
+
+    // Simulation time and application start time
+    double simTime = 60.0;
+    double udpAppStartTime = 0.1;
+
+    // Frequency parameters
+    uint16_t numerologyBwp1 = 4;
+    double centralFrequencyBand1 = 28e9;
+    double bandwidthBand1 = 100e6;
+    uint16_t numerologyBwp2 = 2;
+    double centralFrequencyBand2 = 28.2e9;
+    double bandwidthBand2 = 100e6;
+    double totalTxPower = 55;
+
+    // Scheduler (short name such as PF/RR, or a full TypeId name) and bearer QCI
+    std::string scheduler = "PF";
+    std::string bearer = "GBR_CONV_VOICE";
+    uint16_t dlPort = 1235;
+
+    // Downlink RLC UM queues: limits in bytes and SDUs per bearer (0 means
+    // unbounded), AQM (none or codel) with its target and interval in ms, and
+    // whether to print the queue statistics of every bearer
+    uint32_t rlcMaxBytes = 0;
+    uint32_t rlcMaxPackets = 0;
+    std::string rlcAqm = "none";
+    double rlcAqmTarget = 5.0;
+    double rlcAqmInterval = 100.0;
+    bool rlcQueueStats = false;
+
+    // Recompute the direct path beams of a pair only once its direction
+    // changed by more than this many degrees (0 recomputes every period)
+    double beamAngleThreshold = 0.0;
+    // Time the beamforming calls also without a threshold (baseline)
+    bool beamStats = false;
+
+    // Regeneration period of the 3GPP channel matrices in ms (0 = generated
+    // once per pair)
+    double channelUpdatePeriod = 0.0;
+
+    // Reuse the channel matrix of a gNB/UE pair until one end moved more
+    // than channelCacheDistance meters (0 disables the cache) or it is older
+    // than channelCacheCoherenceTime seconds (0 means no limit); channelStats
+    // counts the matrix generations without reusing them, as a baseline
+    double channelCacheDistance = 0.0;
+    double channelCacheCoherenceTime = 0.0;
+    bool channelCacheCheck = false;
+    bool channelStats = false;
+
+    // Resolution of the FlowMonitor delay/jitter histograms (s), whether to
+    // also measure every packet at the UDP servers and the relative error of
+    // those per-packet latency sketches
+    double delayBinWidth = 0.001;
+    bool packetDelay = false;
+    double latencyPrecision = 0.01;
+
+    // Period of the per-flow KPI time series in seconds (0 disables it) and
+    // whether to also export it as CSV at the end of the run
+    double kpiInterval = 0.0;
+    bool kpiCsv = false;
+
+    // Per slot downlink scheduling statistics of every gNB carrier, keeping
+    // the last macSlotStatsSlots slots of each in memory until the end
+    bool macSlotStats = false;
+    uint32_t macSlotStatsSlots = 16384;
+    // Per UE histograms of the downlink SINR, CQI and MCS, printed with the flows
+    bool linkQuality = false;
+
+    // Stop once the relative 95% CI half width of throughput and delay is
+    // below targetPrecision (0 runs for simTime), but not before minSimTime
+    double targetPrecision = 0.0;
+    double minSimTime = 5.0;
+
+    // Delay of the PGW - remote host link in seconds, and whether to run the
+    // remote host on its own MPI rank (which needs a non-zero delay)
+    double p2pDelay = 0.0;
+    bool distributed = false;
+
+    // Run profile: debug, measurement or fast
+    std::string profile = "debug";
+    // Count events and their wall time per event source
+    bool eventProfile = false;
+    // Period of the memory accounting samples in seconds (0 accounts only at the end)
+    double memoryInterval = 0.0;
+
+    // Animation output: NetAnim xml or compact binary trace, recorded in
+    // [animStart, animStop] (animStop <= 0 means simTime)
+    std::string animFormat = "xml";
+    double animStart = 0.0;
+    double animStop = 0.0;
+    uint32_t animSampling = 1;
+    double animPollInterval = 0.25;
+
+    // Simulation tag (empty: see GetDefaultSimTag()) and output directory
+    std::string simTag;
+    std::string outputDir = "./";
+    // Structured results appended to outputDir/resultsTag-*: none, jsonl or
+    // csv; an empty resultsTag is simTag, the sweeps set it to their own tag
+    std::string results = "none";
+    std::string resultsTag;
+    // File that gets the run record alone, as CSV (set by the sweeps)
+    std::string runRecord;
+
+    /**
+     * Load the defaults of a traffic model ("voice" or "lowlatency").
+     * Values given on the command line are applied on top of the preset.
+     */
+    void ApplyTrafficPreset(const std::string& name);
+
+    /// Bind every parameter to a command line option of the same name
+    void AddToCommandLine(CommandLine& cmd);
+
+    /// Name and value of every parameter, in the order of AddToCommandLine()
+    std::vector<std::pair<std::string, std::string>> GetValues() const;
+
+    /// Full TypeId name of the MAC scheduler, e.g. ns3::NrMacSchedulerTdmaPF
+    std::string GetSchedulerTypeName() const;
+
+    /// Full TypeId name of a scheduler given as on the command line
+    static std::string GetSchedulerTypeName(const std::string& scheduler);
+
+    /// QCI of the dedicated bearer carrying the downlink traffic
+    EpsBearer::Qci GetBearerQci() const;
+
+    /**
+     * Tag of a run without --simTag: traffic model, scheduler and, unless it
+     * is udp, source, e.g. "voice-PF" or "lowlatency-Edf-urllc", so that
+     * runs that differ in them do not overwrite each other's files.
+     */
+    std::string GetDefaultSimTag() const;
+
+    /// Path of an output file for this run: outputDir/simTag followed by suffix
+    std::string GetOutputPath(const std::string& suffix) const;
+
+    /// Path prefix of the results files, shared by the runs with the same resultsTag
+    std::string GetResultsPrefix() const;
+
+    /**
+     * Look for "--name=value" in argv before the CommandLine is parsed.
+     * Used to pick the traffic preset so that explicit options still win.
+     */
+    static std::string FindArgument(int argc, char* argv[], const std::string& name,
+                                    const std::string& defaultValue);
+};
+
+} // namespace ns3
+
+#endif // SCENARIO_PARAMETERS_H
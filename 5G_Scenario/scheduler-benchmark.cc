@@ -0,0 +1,576 @@
+#include "scheduler-benchmark.h"
+
+#include "scenario-parameters.h"
+
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/nr-amc.h"
+#include "ns3/nr-mac-csched-sap.h"
+#include "ns3/nr-mac-sched-sap.h"
+#include "ns3/nr-mac-scheduler-ns3.h"
+#include "ns3/nr-phy-mac-common.h"
+#include "ns3/nr-spectrum-value-helper.h"
+#include "ns3/object-factory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <random>
+#include <sstream>
+#include <tuple>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef SCHEDULER_BENCHMARK_ALLOCATIONS
+// Counting the heap allocations replaces the allocator of the whole
+// process, so it is only compiled into a build made for the benchmark
+// (CXXFLAGS=-DSCHEDULER_BENCHMARK_ALLOCATIONS) and never taxes the scenario
+
+namespace
+{
+
+// Every operator new of the process, read around the measured blocks
+std::atomic<uint64_t> g_heapAllocations{0};
+
+} // namespace
+
+void*
+operator new(std::size_t size)
+{
+    g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size > 0 ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void
+operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+#endif
+
+namespace ns3
+{
+
+namespace
+{
+
+// Slots between two buffer status and CQI reports of every UE
+const uint32_t g_reportPeriod = 10;
+// Buffer reported by every UE, enough to never run empty between reports
+const uint32_t g_backlogBytes = 10000000;
+// Logical channel of the single data bearer of every UE
+const uint8_t g_lcId = 4;
+
+/// Hardware cache misses of this thread in user space, when perf is allowed
+class CacheMissCounter
+{
+  public:
+    CacheMissCounter()
+    {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CacheMissCounter()
+    {
+#ifdef __linux__
+        if (m_fd >= 0)
+        {
+            close(m_fd);
+        }
+#endif
+    }
+
+    bool IsAvailable() const
+    {
+        return m_fd >= 0;
+    }
+
+    void Start()
+    {
+#ifdef __linux__
+        if (m_fd >= 0)
+        {
+            ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    uint64_t Stop()
+    {
+        uint64_t count = 0;
+#ifdef __linux__
+        if (m_fd >= 0)
+        {
+            ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(m_fd, &count, sizeof(count)) != sizeof(count))
+            {
+                count = 0;
+            }
+        }
+#endif
+        return count;
+    }
+
+  private:
+    int m_fd{-1};
+};
+
+/// Stands in for NrGnbMac: fixed cell configuration, acknowledges every DL DCI
+class BenchmarkSchedSapUser : public NrMacSchedSapUser
+{
+  public:
+    explicit BenchmarkSchedSapUser(uint32_t rbgNum)
+        : m_spectrumModel(NrSpectrumValueHelper::GetSpectrumModel(rbgNum, 3.5e9, 15e3))
+    {
+    }
+
+    void SchedConfigInd(const struct SchedConfigIndParameters& params) override
+    {
+        for (const auto& varTti : params.m_slotAllocInfo.m_varTtiAllocInfo)
+        {
+            const auto& dci = varTti.m_dci;
+            if (dci->m_type != DciInfoElementTdma::DATA || dci->m_format != DciInfoElementTdma::DL)
+            {
+                continue;
+            }
+            DlHarqInfo harq;
+            harq.m_rnti = dci->m_rnti;
+            harq.m_harqProcessId = dci->m_harqProcess;
+            harq.m_bwpIndex = 0;
+            harq.m_harqStatus = DlHarqInfo::ACK;
+            harq.m_numRetx = 0;
+            m_feedback.push_back(harq);
+            m_slotDcis.emplace_back(dci->m_rnti, dci->m_symStart, dci->m_numSym);
+            ++m_dcis;
+        }
+    }
+
+    Ptr<const SpectrumModel> GetSpectrumModel() const override
+    {
+        return m_spectrumModel;
+    }
+
+    uint32_t GetNumRbPerRbg() const override
+    {
+        return 1;
+    }
+
+    uint8_t GetNumHarqProcess() const override
+    {
+        return 16;
+    }
+
+    uint16_t GetBwpId() const override
+    {
+        return 0;
+    }
+
+    uint16_t GetCellId() const override
+    {
+        return 1;
+    }
+
+    uint32_t GetSymbolsPerSlot() const override
+    {
+        return 14;
+    }
+
+    Time GetSlotPeriod() const override
+    {
+        return MilliSeconds(1);
+    }
+
+    void BuildRarList(SlotAllocInfo&) override
+    {
+    }
+
+    std::vector<DlHarqInfo> m_feedback;
+    /// RNTI, first symbol and symbols of the DL DCIs of the last slot
+    std::vector<std::tuple<uint16_t, uint8_t, uint8_t>> m_slotDcis;
+    uint64_t m_dcis{0};
+
+  private:
+    Ptr<const SpectrumModel> m_spectrumModel;
+};
+
+double
+Median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    std::size_t n = values.size();
+    return n % 2 == 1 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+std::vector<std::string>
+Split(const std::string& list)
+{
+    std::vector<std::string> items;
+    std::istringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        if (!item.empty())
+        {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+/// One scheduler fed with the synthetic UE population, slot by slot
+class SchedulerDriver
+{
+  public:
+    SchedulerDriver(const ObjectFactory& factory, uint32_t ueNum, uint32_t rbgNum)
+        : m_user(rbgNum),
+          m_ueNum(ueNum),
+          m_rng(1)
+    {
+        m_scheduler = DynamicCast<NrMacSchedulerNs3>(factory.Create());
+        NS_ABORT_MSG_IF(!m_scheduler, factory.GetTypeId().GetName() << " is not an NrMacSchedulerNs3");
+        m_scheduler->InstallDlAmc(CreateObject<NrAmc>());
+        m_scheduler->InstallUlAmc(CreateObject<NrAmc>());
+        m_scheduler->SetMacSchedSapUser(&m_user);
+        NrMacCschedSapProvider* csched = m_scheduler->GetMacCschedSapProvider();
+
+        NrMacCschedSapProvider::CschedCellConfigReqParameters cell;
+        cell.m_dlBandwidth = rbgNum;
+        cell.m_ulBandwidth = rbgNum;
+        csched->CschedCellConfigReq(cell);
+
+        for (uint16_t rnti = 1; rnti <= m_ueNum; ++rnti)
+        {
+            NrMacCschedSapProvider::CschedUeConfigReqParameters ue;
+            ue.m_rnti = rnti;
+            csched->CschedUeConfigReq(ue);
+
+            LogicalChannelConfigListElement_s lc;
+            lc.m_logicalChannelIdentity = g_lcId;
+            lc.m_logicalChannelGroup = 1;
+            lc.m_direction = LogicalChannelConfigListElement_s::DIR_DL;
+            lc.m_qosBearerType = LogicalChannelConfigListElement_s::QBT_NON_GBR;
+            lc.m_qci = 9;
+            lc.m_eRabMaximulBitrateUl = 0;
+            lc.m_eRabMaximulBitrateDl = 0;
+            lc.m_eRabGuaranteedBitrateUl = 0;
+            lc.m_eRabGuaranteedBitrateDl = 0;
+            NrMacCschedSapProvider::CschedLcConfigReqParameters lcConfig;
+            lcConfig.m_rnti = rnti;
+            lcConfig.m_reconfigureFlag = false;
+            lcConfig.m_logicalChannelConfigList.push_back(lc);
+            csched->CschedLcConfigReq(lcConfig);
+        }
+
+        // Every UE reports around its own mean CQI, so PF has something to order
+        std::uniform_int_distribution<int> meanCqi(3, 15);
+        m_meanCqi.resize(m_ueNum);
+        for (auto& cqi : m_meanCqi)
+        {
+            cqi = meanCqi(m_rng);
+        }
+    }
+
+    void RunSlot()
+    {
+        NrMacSchedSapProvider* sched = m_scheduler->GetMacSchedSapProvider();
+        if (m_slot % g_reportPeriod == 0)
+        {
+            std::uniform_int_distribution<int> jitter(-1, 1);
+            NrMacSchedSapProvider::SchedDlCqiInfoReqParameters cqi;
+            cqi.m_sfnsf = m_sfnSf;
+            for (uint16_t rnti = 1; rnti <= m_ueNum; ++rnti)
+            {
+                NrMacSchedSapProvider::SchedDlRlcBufferReqParameters buffer;
+                buffer.m_rnti = rnti;
+                buffer.m_logicalChannelIdentity = g_lcId;
+                buffer.m_rlcTransmissionQueueSize = g_backlogBytes;
+                buffer.m_rlcTransmissionQueueHolDelay = 0;
+                buffer.m_rlcRetransmissionQueueSize = 0;
+                buffer.m_rlcRetransmissionHolDelay = 0;
+                buffer.m_rlcStatusPduSize = 0;
+                sched->SchedDlRlcBufferReq(buffer);
+
+                DlCqiInfo info;
+                info.m_rnti = rnti;
+                info.m_cqiType = DlCqiInfo::WB;
+                info.m_wbCqi = static_cast<uint8_t>(std::clamp(m_meanCqi[rnti - 1] + jitter(m_rng), 1, 15));
+                cqi.m_cqiList.push_back(info);
+            }
+            sched->SchedDlCqiInfoReq(cqi);
+        }
+
+        NrMacSchedSapProvider::SchedDlTriggerReqParameters trigger;
+        trigger.m_snfSf = m_sfnSf;
+        trigger.m_slotType = LteNrTddSlotType::DL;
+        trigger.m_dlHarqInfoList.swap(m_user.m_feedback);
+        m_user.m_slotDcis.clear();
+        sched->SchedDlTriggerReq(trigger);
+        m_sfnSf.Add(1);
+        ++m_slot;
+    }
+
+    const BenchmarkSchedSapUser& GetUser() const
+    {
+        return m_user;
+    }
+
+  private:
+    BenchmarkSchedSapUser m_user;
+    Ptr<NrMacSchedulerNs3> m_scheduler;
+    uint32_t m_ueNum;
+    std::mt19937 m_rng;
+    std::vector<int> m_meanCqi;
+    SfnSf m_sfnSf{0, 0, 0, 0};
+    uint32_t m_slot{0};
+};
+
+} // namespace
+
+SchedulerBenchmark::SchedulerBenchmark(const std::string& scheduler, uint32_t ueNum, uint32_t rbgNum)
+    : m_scheduler(scheduler),
+      m_ueNum(ueNum),
+      m_rbgNum(rbgNum)
+{
+    NS_ABORT_MSG_IF(ueNum == 0 || ueNum > 65000, "The scheduler benchmark needs 1 to 65000 UEs");
+    NS_ABORT_MSG_IF(rbgNum == 0, "The scheduler benchmark needs at least one RBG");
+}
+
+void
+SchedulerBenchmark::SetSlots(uint32_t warmupSlots, uint32_t slots, uint32_t blocks)
+{
+    NS_ABORT_MSG_IF(blocks == 0 || slots < blocks, "Need at least one slot per block");
+    m_warmupSlots = warmupSlots;
+    m_slots = slots;
+    m_blocks = blocks;
+}
+
+SchedulerBenchmark::Result
+SchedulerBenchmark::Run()
+{
+    ObjectFactory factory(m_scheduler);
+    SchedulerDriver driver(factory, m_ueNum, m_rbgNum);
+    for (uint32_t slot = 0; slot < m_warmupSlots; ++slot)
+    {
+        driver.RunSlot();
+    }
+
+    CacheMissCounter cacheMisses;
+    uint32_t blockSlots = m_slots / m_blocks;
+    std::vector<double> nsPerSlot;
+    std::vector<double> allocationsPerSlot;
+    std::vector<double> missesPerSlot;
+    uint64_t dcis = driver.GetUser().m_dcis;
+    for (uint32_t block = 0; block < m_blocks; ++block)
+    {
+#ifdef SCHEDULER_BENCHMARK_ALLOCATIONS
+        uint64_t allocations = g_heapAllocations.load(std::memory_order_relaxed);
+#endif
+        cacheMisses.Start();
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < blockSlots; ++i)
+        {
+            driver.RunSlot();
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        uint64_t misses = cacheMisses.Stop();
+#ifdef SCHEDULER_BENCHMARK_ALLOCATIONS
+        allocations = g_heapAllocations.load(std::memory_order_relaxed) - allocations;
+        allocationsPerSlot.push_back(static_cast<double>(allocations) / blockSlots);
+#endif
+
+        nsPerSlot.push_back(std::chrono::duration<double, std::nano>(elapsed).count() / blockSlots);
+        missesPerSlot.push_back(static_cast<double>(misses) / blockSlots);
+    }
+
+    Result result;
+    result.scheduler = m_scheduler;
+    result.ueNum = m_ueNum;
+    result.rbgNum = m_rbgNum;
+    result.nsPerSlot = Median(nsPerSlot);
+    auto range = std::minmax_element(nsPerSlot.begin(), nsPerSlot.end());
+    result.spread = 100.0 * (*range.second - *range.first) / result.nsPerSlot;
+    result.dcisPerSlot = static_cast<double>(driver.GetUser().m_dcis - dcis) / (blockSlots * m_blocks);
+    result.heapAllocationsPerSlot = allocationsPerSlot.empty() ? -1 : Median(allocationsPerSlot);
+    result.cacheMissesPerSlot = cacheMisses.IsAvailable() ? Median(missesPerSlot) : -1;
+    return result;
+}
+
+std::vector<SchedulerBenchmark::Result>
+SchedulerBenchmark::RunSuite(const std::string& schedulers,
+                             const std::string& ueNums,
+                             const std::string& rbgNums,
+                             uint32_t slots)
+{
+    std::vector<Result> results;
+    for (const auto& scheduler : Split(schedulers))
+    {
+        for (const auto& ueNum : Split(ueNums))
+        {
+            for (const auto& rbgNum : Split(rbgNums))
+            {
+                SchedulerBenchmark benchmark(ScenarioParameters::GetSchedulerTypeName(scheduler),
+                                             std::stoul(ueNum),
+                                             std::stoul(rbgNum));
+                benchmark.SetSlots(slots / 10, slots, 10);
+                results.push_back(benchmark.Run());
+            }
+        }
+    }
+    return results;
+}
+
+bool
+SchedulerBenchmark::CheckIndexedPf(const std::string& ueNums,
+                                   const std::string& rbgNums,
+                                   uint32_t slots,
+                                   std::ostream& os)
+{
+    ObjectFactory stock("ns3::NrMacSchedulerTdmaPF");
+    ObjectFactory reference("ns3::NrMacSchedulerTdmaIndexedPF");
+    reference.Set("UseIndex", BooleanValue(false));
+    ObjectFactory indexed("ns3::NrMacSchedulerTdmaIndexedPF");
+    indexed.Set("UseIndex", BooleanValue(true));
+
+    using SlotDcis = std::vector<std::tuple<uint16_t, uint8_t, uint8_t>>;
+    auto printDcis = [&os](const char* label, const SlotDcis& slotDcis) {
+        os << label;
+        for (const auto& dci : slotDcis)
+        {
+            os << " " << std::get<0>(dci) << "@" << +std::get<1>(dci) << "+" << +std::get<2>(dci);
+        }
+        os << std::endl;
+    };
+
+    bool equivalent = true;
+    for (const auto& ueNum : Split(ueNums))
+    {
+        for (const auto& rbgNum : Split(rbgNums))
+        {
+            SchedulerDriver tdmaPf(stock, std::stoul(ueNum), std::stoul(rbgNum));
+            SchedulerDriver expected(reference, std::stoul(ueNum), std::stoul(rbgNum));
+            SchedulerDriver actual(indexed, std::stoul(ueNum), std::stoul(rbgNum));
+            uint64_t dcis = 0;
+            uint32_t slot = 0;
+            // First slot where the stock scheduler decided otherwise; it is
+            // no longer driven after that, its state having diverged
+            uint32_t stockSlot = slots;
+            SlotDcis stockDcis;
+            SlotDcis referenceDcis;
+            for (; slot < slots; ++slot)
+            {
+                expected.RunSlot();
+                actual.RunSlot();
+                if (stockSlot == slots)
+                {
+                    tdmaPf.RunSlot();
+                    if (tdmaPf.GetUser().m_slotDcis != expected.GetUser().m_slotDcis)
+                    {
+                        stockSlot = slot;
+                        stockDcis = tdmaPf.GetUser().m_slotDcis;
+                        referenceDcis = expected.GetUser().m_slotDcis;
+                    }
+                }
+                if (expected.GetUser().m_slotDcis != actual.GetUser().m_slotDcis)
+                {
+                    break;
+                }
+                dcis += expected.GetUser().m_slotDcis.size();
+            }
+
+            os << ueNum << " UEs, " << rbgNum << " RBGs: ";
+            if (slot == slots)
+            {
+                os << "same " << dcis << " DCIs in " << slots << " slots" << std::endl;
+            }
+            else
+            {
+                equivalent = false;
+                os << "first difference at slot " << slot << std::endl;
+                printDcis("  reference:", expected.GetUser().m_slotDcis);
+                printDcis("  indexed:  ", actual.GetUser().m_slotDcis);
+            }
+
+            os << "  against " << stock.GetTypeId().GetName() << ": ";
+            if (stockSlot == slots)
+            {
+                os << "same decisions in " << slots << " slots" << std::endl;
+            }
+            else
+            {
+                os << "same decisions up to slot " << stockSlot << std::endl;
+                printDcis("    TdmaPF:   ", stockDcis);
+                printDcis("    reference:", referenceDcis);
+            }
+        }
+    }
+    return equivalent;
+}
+
+void
+SchedulerBenchmark::PrintTable(std::ostream& os, const std::vector<Result>& results)
+{
+    std::ios state(nullptr);
+    state.copyfmt(os);
+
+    os << std::left << std::setw(34) << "Scheduler" << std::right << std::setw(7) << "UEs"
+       << std::setw(6) << "RBGs" << std::setw(14) << "ns/slot" << std::setw(9) << "spread"
+       << std::setw(11) << "DCIs/slot" << std::setw(13) << "allocs/slot" << std::setw(14)
+       << "misses/slot" << std::endl;
+    os << std::fixed;
+    for (const auto& r : results)
+    {
+        os << std::left << std::setw(34) << r.scheduler << std::right << std::setw(7) << r.ueNum
+           << std::setw(6) << r.rbgNum << std::setprecision(0) << std::setw(14) << r.nsPerSlot
+           << std::setprecision(1) << std::setw(8) << r.spread << "%" << std::setprecision(2)
+           << std::setw(11) << r.dcisPerSlot << std::setprecision(1);
+        if (r.heapAllocationsPerSlot < 0)
+        {
+            os << std::setw(13) << "n/a";
+        }
+        else
+        {
+            os << std::setw(13) << r.heapAllocationsPerSlot;
+        }
+        if (r.cacheMissesPerSlot < 0)
+        {
+            os << std::setw(14) << "n/a";
+        }
+        else
+        {
+            os << std::setw(14) << r.cacheMissesPerSlot;
+        }
+        os << std::endl;
+    }
+
+    os.copyfmt(state);
+}
+
+} // namespace ns3
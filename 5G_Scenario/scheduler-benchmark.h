@@ -0,0 +1,97 @@
+#ifndef SCHEDULER_BENCHMARK_H
+#define SCHEDULER_BENCHMARK_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Per-slot cost of a downlink MAC scheduler, without the PHY, the channel or
+ * the rest of the simulation.
+ *
+ * The scheduler is created on its own and driven through its SAPs the same
+ * way NrGnbMac does: a cell of rbgNum RBGs (one RB per RBG), ueNum UEs with
+ * one downlink LC each, and then one DL trigger per slot. Every report
+ * period the UEs send a buffer status large enough to stay backlogged and a
+ * new wideband CQI drawn around a per-UE mean, and every HARQ process
+ * scheduled in a slot is acknowledged in the next trigger. The inputs come
+ * from a fixed seed, so two runs feed the scheduler the same sequence.
+ *
+ * The measured slots are split into blocks; the wall time, heap allocations
+ * (only in a build with SCHEDULER_BENCHMARK_ALLOCATIONS defined, which
+ * replaces the global operator new) and cache misses (Linux perf counters,
+ * when the kernel allows them) are reported per slot as the median over the
+ * blocks, together with the spread of the block times.
+ */
+class SchedulerBenchmark
+{
+  public:
+    /// Outcome of one scheduler, UE count and RBG count
+    struct Result
+    {
+        std::string scheduler;
+        uint32_t ueNum{0};
+        uint32_t rbgNum{0};
+        double nsPerSlot{0};
+        /// (max - min) / median of the block times, in %
+        double spread{0};
+        /// Downlink data DCIs per slot
+        double dcisPerSlot{0};
+        /// Negative when the counter is not compiled in (SCHEDULER_BENCHMARK_ALLOCATIONS)
+        double heapAllocationsPerSlot{-1};
+        /// Negative when the counter is not available
+        double cacheMissesPerSlot{-1};
+    };
+
+    SchedulerBenchmark(const std::string& scheduler, uint32_t ueNum, uint32_t rbgNum);
+
+    /// Slots run before measuring, and measured slots split into blocks
+    void SetSlots(uint32_t warmupSlots, uint32_t slots, uint32_t blocks);
+
+    Result Run();
+
+    /**
+     * Run every combination of the comma separated schedulers (as given to
+     * --scheduler), UE counts and RBG counts, each for the given number of
+     * measured slots after a tenth of them as warm-up.
+     */
+    static std::vector<Result> RunSuite(const std::string& schedulers,
+                                        const std::string& ueNums,
+                                        const std::string& rbgNums,
+                                        uint32_t slots);
+
+    /**
+     * Trace equivalence of NrMacSchedulerTdmaIndexedPF: run it with and
+     * without UseIndex on the same inputs, for every UE and RBG count, and
+     * compare the RNTI, first symbol and length of every DL DCI of every
+     * slot. Prints one line per point and returns false on any difference.
+     *
+     * The stock NrMacSchedulerTdmaPF runs on the same inputs too, and the
+     * slot where its decisions first leave those of UseIndex=false is
+     * printed: TDMA PF leaves UEs with the same PF metric in the order of
+     * its hash map, where IndexedPF orders them on the RNTI. That does not
+     * fail the check.
+     */
+    static bool CheckIndexedPf(const std::string& ueNums,
+                               const std::string& rbgNums,
+                               uint32_t slots,
+                               std::ostream& os);
+
+    static void PrintTable(std::ostream& os, const std::vector<Result>& results);
+
+  private:
+    std::string m_scheduler;
+    uint32_t m_ueNum;
+    uint32_t m_rbgNum;
+    uint32_t m_warmupSlots{200};
+    uint32_t m_slots{2000};
+    uint32_t m_blocks{10};
+};
+
+} // namespace ns3
+
+#endif // SCHEDULER_BENCHMARK_H
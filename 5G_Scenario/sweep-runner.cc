@@ -0,0 +1,418 @@
+#include "sweep-runner.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SweepRunner");
+
+namespace
+{
+
+// Split "a,b,c" on a separator, dropping empty fields
+std::vector<std::string>
+Split(const std::string& text, char separator)
+{
+    std::vector<std::string> fields;
+    std::stringstream ss(text);
+    std::string field;
+    while (std::getline(ss, field, separator))
+    {
+        if (!field.empty())
+        {
+            fields.push_back(field);
+        }
+    }
+    return fields;
+}
+
+// Option name of a "--name=value" argument, empty if it is not one
+std::string
+OptionName(const std::string& arg)
+{
+    if (arg.rfind("--", 0) != 0)
+    {
+        return "";
+    }
+    return arg.substr(2, arg.find('=') - 2);
+}
+
+// Fields of a CSV line, with RFC 4180 quoting
+std::vector<std::string>
+SplitCsv(const std::string& line)
+{
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    for (std::size_t i = 0; i < line.size(); ++i)
+    {
+        char c = line[i];
+        if (quoted && c == '"' && i + 1 < line.size() && line[i + 1] == '"')
+        {
+            fields.back() += '"';
+            ++i;
+        }
+        else if (c == '"')
+        {
+            quoted = !quoted;
+        }
+        else if (c == ',' && !quoted)
+        {
+            fields.emplace_back();
+        }
+        else
+        {
+            fields.back() += c;
+        }
+    }
+    return fields;
+}
+
+std::string
+QuoteCsv(const std::string& text)
+{
+    if (text.find_first_of(",\"\r\n") == std::string::npos)
+    {
+        return text;
+    }
+    std::string quoted = "\"";
+    for (char c : text)
+    {
+        quoted += c;
+        if (c == '"')
+        {
+            quoted += '"';
+        }
+    }
+    return quoted + "\"";
+}
+
+} // namespace
+
+SweepRunner::SweepRunner(int argc, char* argv[])
+{
+    char path[PATH_MAX];
+    ssize_t len = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (len > 0)
+    {
+        path[len] = '\0';
+        m_executable = path;
+    }
+    else
+    {
+        m_executable = argv[0];
+    }
+
+    // Keep the original options, except the ones that drive the sweep itself
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string name = OptionName(argv[i]);
+        if (name == "sweep" || name == "scaling" || name == "replications" || name == "compare" ||
+            name == "jobs" || name == "simTag" || name == "runRecord")
+        {
+            continue;
+        }
+        m_baseArgs.emplace_back(argv[i]);
+    }
+}
+
+void
+SweepRunner::SetGrid(const std::string& spec)
+{
+    m_grid.clear();
+    for (const auto& dimension : Split(spec, ';'))
+    {
+        auto eq = dimension.find('=');
+        NS_ABORT_MSG_IF(eq == std::string::npos || eq == 0,
+                        "Malformed sweep dimension '" << dimension << "', expected name=v1,v2");
+        auto values = Split(dimension.substr(eq + 1), ',');
+        NS_ABORT_MSG_IF(values.empty(), "Sweep dimension '" << dimension << "' has no values");
+        m_grid.emplace_back(dimension.substr(0, eq), values);
+    }
+    NS_ABORT_MSG_IF(m_grid.empty(), "Empty sweep specification");
+
+    // Expand the cartesian product, the last dimension varying fastest
+    m_points.clear();
+    std::vector<std::size_t> index(m_grid.size(), 0);
+    while (true)
+    {
+        Point point;
+        for (std::size_t d = 0; d < m_grid.size(); ++d)
+        {
+            point.values.emplace_back(m_grid[d].first, m_grid[d].second[index[d]]);
+        }
+        m_points.push_back(point);
+
+        std::size_t d = m_grid.size();
+        while (d > 0 && ++index[d - 1] == m_grid[d - 1].second.size())
+        {
+            index[d - 1] = 0;
+            --d;
+        }
+        if (d == 0)
+        {
+            break;
+        }
+    }
+}
+
+void
+SweepRunner::SetJobs(uint32_t jobs)
+{
+    m_jobs = jobs;
+}
+
+void
+SweepRunner::SetOutput(const std::string& outputDir, const std::string& simTag)
+{
+    m_outputDir = outputDir;
+    if (!m_outputDir.empty() && m_outputDir.back() != '/')
+    {
+        m_outputDir += '/';
+    }
+    m_simTag = simTag;
+}
+
+void
+SweepRunner::SetDefaultArgument(const std::string& name, const std::string& value)
+{
+    for (const auto& arg : m_baseArgs)
+    {
+        if (OptionName(arg) == name)
+        {
+            return;
+        }
+    }
+    m_baseArgs.push_back("--" + name + "=" + value);
+}
+
+const std::vector<SweepRunner::Point>&
+SweepRunner::GetPoints() const
+{
+    return m_points;
+}
+
+std::vector<std::string>
+SweepRunner::BuildArguments(const Point& point) const
+{
+    std::vector<std::string> args{m_executable};
+    for (const auto& arg : m_baseArgs)
+    {
+        // Grid values override the same option given on the command line
+        bool overridden = false;
+        for (const auto& value : point.values)
+        {
+            overridden = overridden || OptionName(arg) == value.first;
+        }
+        if (!overridden)
+        {
+            args.push_back(arg);
+        }
+    }
+    for (const auto& value : point.values)
+    {
+        args.push_back("--" + value.first + "=" + value.second);
+    }
+    args.push_back("--simTag=" + point.simTag);
+    args.push_back("--runRecord=" + point.recordPath);
+    return args;
+}
+
+int
+SweepRunner::Launch(const Point& point) const
+{
+    std::vector<std::string> args = BuildArguments(point);
+    std::vector<char*> argv;
+    for (auto& arg : args)
+    {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    pid_t pid = fork();
+    NS_ABORT_MSG_IF(pid < 0, "fork() failed while launching " << point.simTag);
+    if (pid == 0)
+    {
+        int fd = open(point.logPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0)
+        {
+            dup2(fd, STDOUT_FILENO);
+            dup2(fd, STDERR_FILENO);
+            close(fd);
+        }
+        execv(m_executable.c_str(), argv.data());
+        _exit(127);
+    }
+    return pid;
+}
+
+int
+SweepRunner::Run()
+{
+    uint32_t jobs = m_jobs;
+    if (jobs == 0)
+    {
+        jobs = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    for (std::size_t i = 0; i < m_points.size(); ++i)
+    {
+        m_points[i].simTag = m_simTag + "-p" + std::to_string(i);
+        m_points[i].logPath = m_outputDir + m_points[i].simTag + ".log";
+        m_points[i].recordPath = m_outputDir + m_points[i].simTag + "-run.csv";
+        // A failed point must not pick up the record of an earlier sweep
+        std::remove(m_points[i].recordPath.c_str());
+    }
+
+    std::cout << "Sweeping " << m_points.size() << " points on " << jobs << " processes"
+              << std::endl;
+
+    std::map<pid_t, std::size_t> running;
+    std::size_t next = 0;
+    int failures = 0;
+    while (next < m_points.size() || !running.empty())
+    {
+        if (next < m_points.size() && running.size() < jobs)
+        {
+            NS_LOG_INFO("Launching " << m_points[next].simTag);
+            running[Launch(m_points[next])] = next;
+            ++next;
+            continue;
+        }
+
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0)
+        {
+            break;
+        }
+        auto it = running.find(pid);
+        if (it == running.end())
+        {
+            continue;
+        }
+        Point& point = m_points[it->second];
+        point.exitStatus = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+        failures += point.exitStatus != 0;
+        std::cout << "  " << point.simTag << " finished with status " << point.exitStatus
+                  << std::endl;
+        running.erase(it);
+    }
+
+    MergeResults();
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+void
+SweepRunner::MergeResults()
+{
+    // Every point that completed wrote its run record; the merged table has
+    // the columns of all of them, in the order they first appear
+    std::vector<std::string> columns;
+    for (auto& point : m_points)
+    {
+        point.results.clear();
+        std::ifstream record(point.recordPath);
+        std::string header;
+        std::string row;
+        if (!std::getline(record, header) || !std::getline(record, row))
+        {
+            continue;
+        }
+        auto names = SplitCsv(header);
+        auto values = SplitCsv(row);
+        for (std::size_t k = 0; k < names.size() && k < values.size(); ++k)
+        {
+            if (std::find(columns.begin(), columns.end(), names[k]) == columns.end())
+            {
+                columns.push_back(names[k]);
+            }
+            point.results[names[k]] = values[k];
+        }
+    }
+
+    std::string csvPath = m_outputDir + m_simTag + "-sweep.csv";
+    std::ofstream csv(csvPath);
+    csv << "point,simTag";
+    for (const auto& dimension : m_grid)
+    {
+        csv << "," << dimension.first;
+    }
+    for (const auto& column : columns)
+    {
+        csv << "," << QuoteCsv(column);
+    }
+    csv << ",exitStatus\n";
+
+    for (std::size_t i = 0; i < m_points.size(); ++i)
+    {
+        const Point& point = m_points[i];
+        csv << i << "," << point.simTag;
+        for (const auto& value : point.values)
+        {
+            csv << "," << QuoteCsv(value.second);
+        }
+        for (const auto& column : columns)
+        {
+            auto result = point.results.find(column);
+            csv << "," << (result != point.results.end() ? QuoteCsv(result->second) : "");
+        }
+        csv << "," << point.exitStatus << "\n";
+    }
+
+    std::cout << "Merged results of " << m_points.size() << " points into " << csvPath
+              << std::endl;
+}
+
+void
+SweepRunner::PrintTable(std::ostream& os, const std::vector<std::string>& columns) const
+{
+    // At least 16 characters, and two more than the column name
+    std::vector<int> widths;
+    os << "\n";
+    for (const auto& column : columns)
+    {
+        widths.push_back(std::max<int>(16, column.size() + 2));
+        os << std::setw(widths.back()) << column;
+    }
+    os << "\n";
+    for (const auto& point : m_points)
+    {
+        for (std::size_t i = 0; i < columns.size(); ++i)
+        {
+            const std::string& column = columns[i];
+            std::string cell = "-";
+            for (const auto& value : point.values)
+            {
+                if (value.first == column)
+                {
+                    cell = value.second;
+                }
+            }
+            auto result = point.results.find(column);
+            if (result != point.results.end() && !result->second.empty())
+            {
+                cell = result->second;
+            }
+            os << std::setw(widths[i]) << cell;
+        }
+        os << "\n";
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,79 @@
+#ifndef SWEEP_RUNNER_H
+#define SWEEP_RUNNER_H
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Runs a parameter grid of the scenario as separate processes.
+ *
+ * The grid is given as "name=v1,v2;name2=v3,v4" and expands to the cartesian
+ * product of the values. Every point re-executes this same binary with the
+ * original command line plus "--name=value" for each grid dimension and its
+ * own --simTag, so at most `jobs` single-threaded simulations run at once.
+ * Each point writes its stdout to outputDir/simTag-pN.log and its run
+ * record (--runRecord) to outputDir/simTag-pN-run.csv; once all of them are
+ * done the records are merged into outputDir/simTag-sweep.csv, one line per
+ * point with the union of their columns.
+ */
+class SweepRunner
+{
+  public:
+    /// One point of the grid and the outcome of the process that ran it
+    struct Point
+    {
+        std::vector<std::pair<std::string, std::string>> values;
+        std::string simTag;
+        std::string logPath;
+        std::string recordPath;
+        int exitStatus{-1};
+        /// Fields of the run record of the point, by column name of the merged table
+        std::map<std::string, std::string> results;
+    };
+
+    SweepRunner(int argc, char* argv[]);
+
+    /// Parse the grid specification, aborting on malformed input
+    void SetGrid(const std::string& spec);
+
+    /// Maximum number of concurrent processes (0 means one per core)
+    void SetJobs(uint32_t jobs);
+
+    /// Directory and tag used to name the per-point logs and the merged table
+    void SetOutput(const std::string& outputDir, const std::string& simTag);
+
+    /// Pass "--name=value" to every point unless the command line sets the option
+    void SetDefaultArgument(const std::string& name, const std::string& value);
+
+    /// Launch every point, wait for all of them and merge the results
+    int Run();
+
+    const std::vector<Point>& GetPoints() const;
+
+    /// Print the grid values and the given result columns of every point, after Run()
+    void PrintTable(std::ostream& os, const std::vector<std::string>& columns) const;
+
+  private:
+    std::vector<std::string> BuildArguments(const Point& point) const;
+    int Launch(const Point& point) const;
+    void MergeResults();
+
+    std::string m_executable;
+    std::vector<std::string> m_baseArgs;
+    std::vector<std::pair<std::string, std::vector<std::string>>> m_grid;
+    std::vector<Point> m_points;
+    uint32_t m_jobs{0};
+    std::string m_outputDir{"./"};
+    std::string m_simTag{"default"};
+};
+
+} // namespace ns3
+
+#endif // SWEEP_RUNNER_H
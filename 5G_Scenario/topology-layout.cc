@@ -0,0 +1,47 @@
+#include "topology-layout.h"
+
+#include "ns3/abort.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+TopologyLayout
+TopologyLayout::Generate(uint16_t gNbNum, uint32_t ueNum, const std::string& layout, double spacing)
+{
+    NS_ABORT_MSG_IF(gNbNum == 0, "At least one gNB is needed");
+    TopologyLayout result;
+
+    uint32_t gnbColumns = gNbNum;
+    if (layout == "grid")
+    {
+        gnbColumns = std::ceil(std::sqrt(gNbNum));
+    }
+    else
+    {
+        NS_ABORT_MSG_IF(layout != "row", "Unknown gNB layout " << layout << " (expected row or grid)");
+    }
+
+    double maxX = 0;
+    double maxY = 0;
+    for (uint32_t i = 0; i < gNbNum; ++i)
+    {
+        Vector position(30.0 + spacing * (i % gnbColumns), 50.0 + spacing * (i / gnbColumns), 10.0);
+        result.gnbPositions.push_back(position);
+        maxX = std::max(maxX, position.x);
+        maxY = std::max(maxY, position.y);
+    }
+
+    result.ueOrigin = Vector(30.0, 60.0, 1.5);
+    result.ueGridWidth = std::max<uint32_t>(5, std::ceil(std::sqrt(ueNum)));
+    uint32_t ueRows = (ueNum + result.ueGridWidth - 1) / result.ueGridWidth;
+    maxX = std::max(maxX, result.ueOrigin.x + result.ueSpacing * (result.ueGridWidth - 1));
+    maxY = std::max(maxY, result.ueOrigin.y + result.ueSpacing * (std::max<uint32_t>(ueRows, 1) - 1));
+
+    result.bounds = Rectangle(0, std::max(200.0, maxX + 30.0), 0, std::max(100.0, maxY + 30.0));
+    return result;
+}
+
+} // namespace ns3
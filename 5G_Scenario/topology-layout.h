@@ -0,0 +1,37 @@
+#ifndef TOPOLOGY_LAYOUT_H
+#define TOPOLOGY_LAYOUT_H
+
+#include "ns3/rectangle.h"
+#include "ns3/vector.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Positions of the gNBs and UEs for any number of nodes.
+ *
+ * gNBs are placed `spacing` metres apart starting at (30, 50), either on a
+ * single row ("row") or on a square grid ("grid") for dense deployments. UEs
+ * start on a grid of 10 m cells at (30, 60), at least 5 per row, and move
+ * inside bounds that cover both grids with a 30 m margin (never smaller than
+ * the original 200 x 100 m area). With 3 gNBs and 5 UEs in a row this is the
+ * original topology.
+ */
+struct TopologyLayout
+{
+    std::vector<Vector> gnbPositions;
+    Vector ueOrigin;
+    double ueSpacing{10.0};
+    uint32_t ueGridWidth{5};
+    Rectangle bounds;
+
+    static TopologyLayout Generate(uint16_t gNbNum, uint32_t ueNum, const std::string& layout, double spacing);
+};
+
+} // namespace ns3
+
+#endif // TOPOLOGY_LAYOUT_H
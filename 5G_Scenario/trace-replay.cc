@@ -0,0 +1,489 @@
+#include "trace-replay.h"
+
+#include "ns3/abort.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/seq-ts-header.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(TraceReplayClient);
+
+namespace
+{
+
+// Read bytes handed back to the kernel at a time
+const std::size_t g_releaseBytes = 8 << 20;
+
+// pcap link types
+const uint32_t g_linkEthernet = 1;
+const uint32_t g_linkRaw = 101;
+const uint32_t g_linkLinuxSll = 113;
+const uint32_t g_linkIpv4 = 228;
+
+uint16_t
+ReadBe16(const uint8_t* p)
+{
+    return static_cast<uint16_t>(p[0] << 8 | p[1]);
+}
+
+uint32_t
+ReadBe32(const uint8_t* p)
+{
+    return static_cast<uint32_t>(p[0]) << 24 | static_cast<uint32_t>(p[1]) << 16 |
+           static_cast<uint32_t>(p[2]) << 8 | p[3];
+}
+
+/// FNV-1a over the bytes of a flow key
+uint64_t
+HashBytes(const uint8_t* p, std::size_t n, uint64_t hash = 14695981039346656037ULL)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        hash = (hash ^ p[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool
+IsBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+/// Unsigned integer at the front of [p, end), after blanks
+bool
+ParseUnsigned(const char*& p, const char* end, uint64_t* value)
+{
+    while (p < end && IsBlank(*p))
+    {
+        ++p;
+    }
+    const char* start = p;
+    *value = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        *value = *value * 10 + (*p - '0');
+        ++p;
+    }
+    return p > start;
+}
+
+/// Decimal seconds at the front of [p, end), in nanoseconds
+bool
+ParseSeconds(const char*& p, const char* end, uint64_t* ns)
+{
+    uint64_t seconds;
+    if (!ParseUnsigned(p, end, &seconds))
+    {
+        return false;
+    }
+    uint64_t fraction = 0;
+    uint64_t scale = 1000000000;
+    if (p < end && *p == '.')
+    {
+        ++p;
+        while (p < end && *p >= '0' && *p <= '9')
+        {
+            if (scale > 1)
+            {
+                scale /= 10;
+                fraction += (*p - '0') * scale;
+            }
+            ++p;
+        }
+    }
+    *ns = seconds * 1000000000 + fraction;
+    return true;
+}
+
+/// Separator between two fields, blanks allowed around it
+bool
+ParseComma(const char*& p, const char* end)
+{
+    while (p < end && IsBlank(*p))
+    {
+        ++p;
+    }
+    if (p == end || *p != ',')
+    {
+        return false;
+    }
+    ++p;
+    return true;
+}
+
+} // namespace
+
+PacketTraceReader::~PacketTraceReader()
+{
+    Close();
+}
+
+void
+PacketTraceReader::Open(const std::string& path, const std::string& format)
+{
+    NS_ABORT_MSG_IF(format != "auto" && format != "text" && format != "pcap",
+                    "Unknown trace format " << format << " (expected auto, text or pcap)");
+    Close();
+    int fd = open(path.c_str(), O_RDONLY);
+    NS_ABORT_MSG_IF(fd < 0, "Cannot open the packet trace " << path);
+    struct stat status;
+    NS_ABORT_MSG_IF(fstat(fd, &status) != 0, "Cannot read the size of the packet trace " << path);
+    m_size = status.st_size;
+    if (m_size > 0)
+    {
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        NS_ABORT_MSG_IF(data == MAP_FAILED, "Cannot map the packet trace " << path);
+        madvise(data, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const uint8_t*>(data);
+    }
+    close(fd);
+
+    // The magic number gives the byte order and the time stamp resolution
+    uint32_t magic = m_size >= 24 ? ReadBe32(m_data) : 0;
+    m_pcap = true;
+    if (magic == 0xa1b2c3d4 || magic == 0xa1b23c4d)
+    {
+        m_bigEndian = true;
+        m_nanoseconds = magic == 0xa1b23c4d;
+    }
+    else if (magic == 0xd4c3b2a1 || magic == 0x4d3cb2a1)
+    {
+        m_bigEndian = false;
+        m_nanoseconds = magic == 0x4d3cb2a1;
+    }
+    else
+    {
+        m_pcap = false;
+    }
+    NS_ABORT_MSG_IF(format == "pcap" && !m_pcap, path << " is not a pcap file");
+    if (format == "text")
+    {
+        m_pcap = false;
+    }
+    if (m_pcap)
+    {
+        m_linkType = ReadPcap32(20) & 0xffff;
+        m_position = 24;
+    }
+}
+
+void
+PacketTraceReader::Close()
+{
+    if (m_data)
+    {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_position = 0;
+    m_released = 0;
+    m_hasFirst = false;
+    m_records = 0;
+    m_skipped = 0;
+}
+
+bool
+PacketTraceReader::Next(Record* record)
+{
+    bool found = m_pcap ? NextPcap(record) : NextText(record);
+    if (!found)
+    {
+        return false;
+    }
+    if (!m_hasFirst)
+    {
+        m_hasFirst = true;
+        m_firstNs = record->timeNs;
+    }
+    // A record older than the first one is replayed at the start
+    record->timeNs = record->timeNs > m_firstNs ? record->timeNs - m_firstNs : 0;
+    ++m_records;
+    if (m_position - m_released >= g_releaseBytes)
+    {
+        Release();
+    }
+    return true;
+}
+
+uint64_t
+PacketTraceReader::GetRecords() const
+{
+    return m_records;
+}
+
+uint64_t
+PacketTraceReader::GetSkipped() const
+{
+    return m_skipped;
+}
+
+bool
+PacketTraceReader::NextText(Record* record)
+{
+    while (m_position < m_size)
+    {
+        const char* begin = reinterpret_cast<const char*>(m_data) + m_position;
+        const char* end = static_cast<const char*>(std::memchr(begin, '\n', m_size - m_position));
+        if (!end)
+        {
+            end = reinterpret_cast<const char*>(m_data) + m_size;
+        }
+        m_position = end - reinterpret_cast<const char*>(m_data) + 1;
+
+        const char* p = begin;
+        while (p < end && IsBlank(*p))
+        {
+            ++p;
+        }
+        if (p == end || *p == '#')
+        {
+            continue;
+        }
+
+        uint64_t size;
+        uint64_t flow;
+        if (ParseSeconds(p, end, &record->timeNs) && ParseComma(p, end) && ParseUnsigned(p, end, &size) &&
+            ParseComma(p, end) && ParseUnsigned(p, end, &flow))
+        {
+            record->size = static_cast<uint32_t>(std::min<uint64_t>(size, UINT32_MAX));
+            record->flow = flow;
+            return true;
+        }
+        ++m_skipped;
+    }
+    m_position = m_size;
+    return false;
+}
+
+bool
+PacketTraceReader::NextPcap(Record* record)
+{
+    if (m_position + 16 > m_size)
+    {
+        m_position = m_size;
+        return false;
+    }
+    uint64_t seconds = ReadPcap32(m_position);
+    uint64_t fraction = ReadPcap32(m_position + 4);
+    uint32_t captured = ReadPcap32(m_position + 8);
+    uint32_t original = ReadPcap32(m_position + 12);
+    if (m_position + 16 + captured > m_size)
+    {
+        ++m_skipped;
+        m_position = m_size;
+        return false;
+    }
+    const uint8_t* frame = m_data + m_position + 16;
+    m_position += 16 + captured;
+
+    record->timeNs = seconds * 1000000000 + fraction * (m_nanoseconds ? 1 : 1000);
+    record->size = original;
+    record->flow = UINT64_MAX;
+
+    // Offset of the IPv4 header, if the frame carries one
+    std::size_t ip = SIZE_MAX;
+    if (m_linkType == g_linkEthernet && captured >= 14)
+    {
+        std::size_t type = 12;
+        if (ReadBe16(frame + type) == 0x8100 && captured >= 18)
+        {
+            type += 4;
+        }
+        ip = ReadBe16(frame + type) == 0x0800 ? type + 2 : SIZE_MAX;
+    }
+    else if (m_linkType == g_linkLinuxSll && captured >= 16)
+    {
+        ip = ReadBe16(frame + 14) == 0x0800 ? 16 : SIZE_MAX;
+    }
+    else if (m_linkType == g_linkRaw || m_linkType == g_linkIpv4)
+    {
+        ip = 0;
+    }
+    if (ip == SIZE_MAX || captured < ip + 20 || (frame[ip] >> 4) != 4)
+    {
+        return true;
+    }
+
+    // Addresses and protocol, and the ports of TCP and UDP
+    std::size_t headerLength = (frame[ip] & 0x0f) * 4;
+    uint8_t protocol = frame[ip + 9];
+    uint64_t flow = HashBytes(frame + ip + 12, 8);
+    flow = HashBytes(&protocol, 1, flow);
+    if ((protocol == 6 || protocol == 17) && captured >= ip + headerLength + 4)
+    {
+        flow = HashBytes(frame + ip + headerLength, 4, flow);
+    }
+    uint16_t totalLength = ReadBe16(frame + ip + 2);
+    record->flow = flow;
+    record->size = totalLength > headerLength + 8 ? totalLength - headerLength - 8 : 0;
+    return true;
+}
+
+uint32_t
+PacketTraceReader::ReadPcap32(std::size_t offset) const
+{
+    const uint8_t* p = m_data + offset;
+    if (m_bigEndian)
+    {
+        return ReadBe32(p);
+    }
+    return static_cast<uint32_t>(p[3]) << 24 | static_cast<uint32_t>(p[2]) << 16 |
+           static_cast<uint32_t>(p[1]) << 8 | p[0];
+}
+
+void
+PacketTraceReader::Release()
+{
+    std::size_t page = sysconf(_SC_PAGESIZE);
+    std::size_t end = m_position / page * page;
+    if (end > m_released)
+    {
+        madvise(const_cast<uint8_t*>(m_data) + m_released, end - m_released, MADV_DONTNEED);
+        m_released = end;
+    }
+}
+
+TypeId
+TraceReplayClient::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::TraceReplayClient")
+                            .SetParent<Application>()
+                            .SetGroupName("Applications")
+                            .AddConstructor<TraceReplayClient>()
+                            .AddAttribute("TraceFile",
+                                          "Packet trace to replay",
+                                          StringValue(""),
+                                          MakeStringAccessor(&TraceReplayClient::m_traceFile),
+                                          MakeStringChecker())
+                            .AddAttribute("Format",
+                                          "Format of the trace: auto, text or pcap",
+                                          StringValue("auto"),
+                                          MakeStringAccessor(&TraceReplayClient::m_format),
+                                          MakeStringChecker())
+                            .AddAttribute("RemotePort",
+                                          "Destination port of every flow",
+                                          UintegerValue(100),
+                                          MakeUintegerAccessor(&TraceReplayClient::m_peerPort),
+                                          MakeUintegerChecker<uint16_t>())
+                            .AddTraceSource("Tx",
+                                            "A packet is sent",
+                                            MakeTraceSourceAccessor(&TraceReplayClient::m_txTrace),
+                                            "ns3::Packet::TracedCallback");
+    return tid;
+}
+
+TraceReplayClient::TraceReplayClient()
+{
+}
+
+TraceReplayClient::~TraceReplayClient()
+{
+}
+
+void
+TraceReplayClient::AddDestination(Address address)
+{
+    NS_ABORT_MSG_IF(!Ipv4Address::IsMatchingType(address), "TraceReplayClient needs IPv4 destinations");
+    m_destinations.push_back(InetSocketAddress(Ipv4Address::ConvertFrom(address), m_peerPort));
+    m_sequence.push_back(0);
+}
+
+uint64_t
+TraceReplayClient::GetSent() const
+{
+    return m_sent;
+}
+
+uint64_t
+TraceReplayClient::GetFlows() const
+{
+    return m_flowDestination.size();
+}
+
+void
+TraceReplayClient::DoDispose()
+{
+    m_socket = nullptr;
+    m_reader.Close();
+    Application::DoDispose();
+}
+
+void
+TraceReplayClient::StartApplication()
+{
+    NS_ABORT_MSG_IF(m_destinations.empty(), "TraceReplayClient has no destination");
+    if (!m_socket)
+    {
+        m_socket = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
+        m_socket->Bind();
+    }
+    m_reader.Open(m_traceFile, m_format);
+    m_startTime = Simulator::Now();
+    m_hasNext = m_reader.Next(&m_next);
+    ScheduleNext();
+}
+
+void
+TraceReplayClient::StopApplication()
+{
+    Simulator::Cancel(m_sendEvent);
+    m_hasNext = false;
+    m_reader.Close();
+}
+
+void
+TraceReplayClient::ScheduleNext()
+{
+    if (!m_hasNext)
+    {
+        return;
+    }
+    Time wait = m_startTime + NanoSeconds(m_next.timeNs) - Simulator::Now();
+    m_sendEvent = Simulator::Schedule(std::max(wait, Seconds(0)), &TraceReplayClient::SendDue, this);
+}
+
+void
+TraceReplayClient::SendDue()
+{
+    // Records with the same time stamp go out in one event
+    do
+    {
+        auto it = m_flowDestination.find(m_next.flow);
+        if (it == m_flowDestination.end())
+        {
+            it = m_flowDestination.emplace(m_next.flow, m_flowDestination.size() % m_destinations.size()).first;
+        }
+        uint32_t destination = it->second;
+
+        SeqTsHeader seqTs;
+        seqTs.SetSeq(m_sequence[destination]++);
+        uint32_t payload = m_next.size > seqTs.GetSerializedSize() ? m_next.size - seqTs.GetSerializedSize() : 0;
+        Ptr<Packet> packet = Create<Packet>(payload);
+        packet->AddHeader(seqTs);
+        m_txTrace(packet);
+        if (m_socket->SendTo(packet, 0, m_destinations[destination]) >= 0)
+        {
+            ++m_sent;
+        }
+        m_hasNext = m_reader.Next(&m_next);
+    } while (m_hasNext && m_startTime + NanoSeconds(m_next.timeNs) <= Simulator::Now());
+    ScheduleNext();
+}
+
+} // namespace ns3
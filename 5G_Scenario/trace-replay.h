@@ -0,0 +1,143 @@
+#ifndef TRACE_REPLAY_H
+#define TRACE_REPLAY_H
+
+#include "ns3/address.h"
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/socket.h"
+#include "ns3/traced-callback.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Sequential reader of a packet trace mapped into memory.
+ *
+ * Two formats are read:
+ * - text, one packet per line: "time,size,flow" with the time in seconds
+ *   (decimal), the UDP payload in bytes and an integer flow id; empty lines
+ *   and lines starting with '#' are skipped
+ * - pcap (microsecond or nanosecond, either byte order) of Ethernet, Linux
+ *   cooked or raw IP frames: the flow is the IPv4 5-tuple and the size the
+ *   IP payload less the UDP header; other frames are one flow of their own
+ *
+ * The file is never read as a whole: records are parsed in place as the
+ * replay reaches them, and the pages behind the read position are handed
+ * back to the kernel every few MB so the resident size stays flat however
+ * large the trace is.
+ */
+class PacketTraceReader
+{
+  public:
+    struct Record
+    {
+        /// Time since the first record
+        uint64_t timeNs{0};
+        uint32_t size{0};
+        uint64_t flow{0};
+    };
+
+    PacketTraceReader() = default;
+    ~PacketTraceReader();
+    PacketTraceReader(const PacketTraceReader&) = delete;
+    PacketTraceReader& operator=(const PacketTraceReader&) = delete;
+
+    /// Map the file, aborting when it cannot be read; format is auto, text or pcap
+    void Open(const std::string& path, const std::string& format = "auto");
+    void Close();
+
+    /// Next record in file order, false at the end of the trace
+    bool Next(Record* record);
+
+    uint64_t GetRecords() const;
+    /// Malformed text lines and truncated pcap records that were skipped
+    uint64_t GetSkipped() const;
+
+  private:
+    bool NextText(Record* record);
+    bool NextPcap(Record* record);
+    /// 32 bit field of the pcap headers, in the byte order of the file
+    uint32_t ReadPcap32(std::size_t offset) const;
+    /// Give the pages before the read position back to the kernel
+    void Release();
+
+    const uint8_t* m_data{nullptr};
+    std::size_t m_size{0};
+    std::size_t m_position{0};
+    std::size_t m_released{0};
+
+    bool m_pcap{false};
+    bool m_bigEndian{false};
+    bool m_nanoseconds{false};
+    uint32_t m_linkType{0};
+
+    bool m_hasFirst{false};
+    uint64_t m_firstNs{0};
+    uint64_t m_records{0};
+    uint64_t m_skipped{0};
+};
+
+/**
+ * Downlink replay of a packet trace over the UEs.
+ *
+ * Every flow of the trace is given to a destination, in the order in which
+ * the flows first appear and round robin over the destinations, and its
+ * packets are sent from one socket to the RemotePort of that destination at
+ * their trace time after the start of the application. Each packet carries
+ * a SeqTsHeader numbered per destination, as UdpClient does, so the UDP
+ * servers, FlowMonitor and the delay probe see the replayed traffic as
+ * usual. Packets smaller than the header are sent with 12 bytes.
+ */
+class TraceReplayClient : public Application
+{
+  public:
+    static TypeId GetTypeId();
+
+    TraceReplayClient();
+    ~TraceReplayClient() override;
+
+    /// Add a UE address that flows of the trace are mapped onto
+    void AddDestination(Address address);
+
+    uint64_t GetSent() const;
+    uint64_t GetFlows() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    void StartApplication() override;
+    void StopApplication() override;
+
+    /// Send every record due now and schedule the next one
+    void SendDue();
+    void ScheduleNext();
+
+    std::string m_traceFile;
+    std::string m_format;
+    uint16_t m_peerPort;
+
+    PacketTraceReader m_reader;
+    PacketTraceReader::Record m_next;
+    bool m_hasNext{false};
+    Time m_startTime;
+
+    Ptr<Socket> m_socket;
+    EventId m_sendEvent;
+    std::vector<Address> m_destinations;
+    std::vector<uint32_t> m_sequence;
+    std::unordered_map<uint64_t, uint32_t> m_flowDestination;
+    uint64_t m_sent{0};
+
+    TracedCallback<Ptr<const Packet>> m_txTrace;
+};
+
+} // namespace ns3
+
+#endif // TRACE_REPLAY_H
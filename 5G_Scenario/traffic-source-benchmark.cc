@@ -0,0 +1,169 @@
+#include "traffic-source-benchmark.h"
+
+#include "memory-accounting.h"
+#include "multiplexed-udp-client.h"
+
+#include "ns3/application-container.h"
+#include "ns3/callback.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/ipv4.h"
+#include "ns3/node-container.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/udp-client-server-helper.h"
+#include "ns3/uinteger.h"
+
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+namespace ns3
+{
+
+namespace
+{
+
+// Destination port, as the downlink traffic of the scenario
+const uint16_t g_port = 1234;
+
+void
+CountPacket(uint64_t* packets, Ptr<const Packet>)
+{
+    ++*packets;
+}
+
+} // namespace
+
+TrafficSourceBenchmark::Result
+TrafficSourceBenchmark::Run(bool multiplexed, uint32_t ueNum, uint32_t packetSize, Time interval, Time duration)
+{
+    // Remote host and a node that swallows every packet
+    NodeContainer nodes;
+    nodes.Create(2);
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", StringValue("100Gbps"));
+    p2p.SetChannelAttribute("Delay", StringValue("0s"));
+    p2p.SetQueue("ns3::DropTailQueue", "MaxSize", StringValue(std::to_string(ueNum + 1) + "p"));
+    NetDeviceContainer devices = p2p.Install(nodes);
+
+    // No queue disc on the device, and every UE address is routed into the link
+    InternetStackHelper internet;
+    internet.Install(nodes.Get(0));
+    Ptr<Ipv4> ipv4 = nodes.Get(0)->GetObject<Ipv4>();
+    int32_t interface = ipv4->AddInterface(devices.Get(0));
+    ipv4->AddAddress(interface, Ipv4InterfaceAddress(Ipv4Address("1.0.0.1"), Ipv4Mask("255.0.0.0")));
+    ipv4->SetUp(interface);
+    Ipv4StaticRoutingHelper routing;
+    routing.GetStaticRouting(ipv4)->AddNetworkRouteTo(Ipv4Address("7.0.0.0"), Ipv4Mask("255.0.0.0"), interface);
+
+    double heapBefore = MemoryAccounting::GetHeapBytes();
+    uint64_t packets = 0;
+    ApplicationContainer apps;
+    if (multiplexed)
+    {
+        Ptr<MultiplexedUdpClient> client = CreateObject<MultiplexedUdpClient>();
+        client->SetAttribute("RemotePort", UintegerValue(g_port));
+        client->SetAttribute("MaxPackets", UintegerValue(0));
+        client->SetAttribute("PacketSize", UintegerValue(packetSize));
+        client->SetAttribute("Interval", TimeValue(interval));
+        for (uint32_t i = 0; i < ueNum; ++i)
+        {
+            client->AddDestination(Ipv4Address(0x07000002 + i));
+        }
+        client->TraceConnectWithoutContext("Tx", MakeBoundCallback(&CountPacket, &packets));
+        nodes.Get(0)->AddApplication(client);
+        apps.Add(client);
+    }
+    else
+    {
+        UdpClientHelper client;
+        client.SetAttribute("RemotePort", UintegerValue(g_port));
+        client.SetAttribute("MaxPackets", UintegerValue(0xFFFFFFFF));
+        client.SetAttribute("PacketSize", UintegerValue(packetSize));
+        client.SetAttribute("Interval", TimeValue(interval));
+        for (uint32_t i = 0; i < ueNum; ++i)
+        {
+            client.SetAttribute("RemoteAddress", AddressValue(Ipv4Address(0x07000002 + i)));
+            ApplicationContainer app = client.Install(nodes.Get(0));
+            app.Get(0)->TraceConnectWithoutContext("Tx", MakeBoundCallback(&CountPacket, &packets));
+            apps.Add(app);
+        }
+    }
+    apps.Start(Seconds(0));
+    apps.Stop(duration);
+
+    Simulator::Stop(duration);
+    uint64_t events = Simulator::GetEventCount();
+    auto start = std::chrono::steady_clock::now();
+    Simulator::Run();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    Result result;
+    result.source = multiplexed ? "MultiplexedUdpClient" : "UdpClient";
+    result.ueNum = ueNum;
+    result.packets = packets;
+    result.events = Simulator::GetEventCount() - events;
+    result.wallSeconds = std::chrono::duration<double>(elapsed).count();
+    double heapAfter = MemoryAccounting::GetHeapBytes();
+    if (heapBefore >= 0 && heapAfter >= 0)
+    {
+        result.heapBytesPerUe = (heapAfter - heapBefore) / ueNum;
+    }
+    Simulator::Destroy();
+    return result;
+}
+
+std::vector<TrafficSourceBenchmark::Result>
+TrafficSourceBenchmark::RunSuite(const std::string& ueNums, uint32_t packetSize, Time interval, Time duration)
+{
+    std::vector<Result> results;
+    std::istringstream list(ueNums);
+    std::string ueNum;
+    while (std::getline(list, ueNum, ','))
+    {
+        if (ueNum.empty())
+        {
+            continue;
+        }
+        for (bool multiplexed : {false, true})
+        {
+            results.push_back(Run(multiplexed, std::stoul(ueNum), packetSize, interval, duration));
+        }
+    }
+    return results;
+}
+
+void
+TrafficSourceBenchmark::PrintTable(std::ostream& os, const std::vector<Result>& results)
+{
+    std::ios state(nullptr);
+    state.copyfmt(os);
+
+    os << std::left << std::setw(22) << "Source" << std::right << std::setw(7) << "UEs" << std::setw(12)
+       << "packets" << std::setw(12) << "events" << std::setw(10) << "wall s" << std::setw(14)
+       << "events/s" << std::setw(12) << "events/pkt" << std::setw(12) << "heap B/UE" << std::endl;
+    os << std::fixed;
+    for (const auto& r : results)
+    {
+        os << std::left << std::setw(22) << r.source << std::right << std::setw(7) << r.ueNum
+           << std::setw(12) << r.packets << std::setw(12) << r.events << std::setprecision(2)
+           << std::setw(10) << r.wallSeconds << std::setprecision(0) << std::setw(14)
+           << (r.wallSeconds > 0 ? r.events / r.wallSeconds : 0) << std::setprecision(2)
+           << std::setw(12) << (r.packets > 0 ? static_cast<double>(r.events) / r.packets : 0);
+        if (r.heapBytesPerUe < 0)
+        {
+            os << std::setw(12) << "n/a";
+        }
+        else
+        {
+            os << std::setprecision(0) << std::setw(12) << r.heapBytesPerUe;
+        }
+        os << std::endl;
+    }
+
+    os.copyfmt(state);
+}
+
+} // namespace ns3
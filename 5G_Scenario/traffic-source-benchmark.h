@@ -0,0 +1,55 @@
+#ifndef TRAFFIC_SOURCE_BENCHMARK_H
+#define TRAFFIC_SOURCE_BENCHMARK_H
+
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Cost of the downlink traffic sources on their own: one UdpClient per UE
+ * against one MultiplexedUdpClient for all of them.
+ *
+ * The sources run on a remote host whose only route leads into a 100 Gbps
+ * point-to-point link to a node without an IP stack, so every packet goes
+ * through the socket, UDP, IP and the device and is then dropped; nothing
+ * but the sources differs between the two runs. The heap in use (glibc
+ * mallinfo2) is read once the two nodes, their link, stack and routes exist
+ * and again after the run, so the per-UE number leaves out that fixed
+ * topology and covers the sources and what they leave behind.
+ */
+class TrafficSourceBenchmark
+{
+  public:
+    /// Outcome of one source and UE count
+    struct Result
+    {
+        std::string source;
+        uint32_t ueNum{0};
+        uint64_t packets{0};
+        uint64_t events{0};
+        double wallSeconds{0};
+        /// Heap growth from installing the sources to the end of the run, per UE; negative when unknown
+        double heapBytesPerUe{-1};
+    };
+
+    /// Both sources for every comma separated UE count, for the given simulated time
+    static std::vector<Result> RunSuite(const std::string& ueNums,
+                                        uint32_t packetSize,
+                                        Time interval,
+                                        Time duration);
+
+    static void PrintTable(std::ostream& os, const std::vector<Result>& results);
+
+  private:
+    static Result Run(bool multiplexed, uint32_t ueNum, uint32_t packetSize, Time interval, Time duration);
+};
+
+} // namespace ns3
+
+#endif // TRAFFIC_SOURCE_BENCHMARK_H
@@ -0,0 +1,444 @@
+#include "urllc-traffic.h"
+
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/seq-ts-header.h"
+#include "ns3/simulator.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(DeadlineHeader);
+NS_OBJECT_ENSURE_REGISTERED(UrllcSource);
+NS_OBJECT_ENSURE_REGISTERED(UrllcSink);
+
+TypeId
+DeadlineHeader::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::DeadlineHeader").SetParent<Header>().SetGroupName("Applications").AddConstructor<DeadlineHeader>();
+    return tid;
+}
+
+TypeId
+DeadlineHeader::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+void
+DeadlineHeader::SetDeadline(Time deadline)
+{
+    m_deadline = deadline.GetTimeStep();
+}
+
+Time
+DeadlineHeader::GetDeadline() const
+{
+    return TimeStep(m_deadline);
+}
+
+uint32_t
+DeadlineHeader::GetSerializedSize() const
+{
+    return 8;
+}
+
+void
+DeadlineHeader::Serialize(Buffer::Iterator start) const
+{
+    start.WriteHtonU64(m_deadline);
+}
+
+uint32_t
+DeadlineHeader::Deserialize(Buffer::Iterator start)
+{
+    m_deadline = start.ReadNtohU64();
+    return GetSerializedSize();
+}
+
+void
+DeadlineHeader::Print(std::ostream& os) const
+{
+    os << "(deadline=" << TimeStep(m_deadline).As(Time::MS) << ")";
+}
+
+TypeId
+UrllcSource::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::UrllcSource")
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .AddConstructor<UrllcSource>()
+            .AddAttribute("RemoteAddress",
+                          "Destination address of the packets",
+                          AddressValue(),
+                          MakeAddressAccessor(&UrllcSource::m_peerAddress),
+                          MakeAddressChecker())
+            .AddAttribute("RemotePort",
+                          "Destination port of the packets",
+                          UintegerValue(100),
+                          MakeUintegerAccessor(&UrllcSource::m_peerPort),
+                          MakeUintegerChecker<uint16_t>())
+            .AddAttribute("PacketSize",
+                          "UDP payload of a packet, headers included (at least 20 bytes)",
+                          UintegerValue(32),
+                          MakeUintegerAccessor(&UrllcSource::m_packetSize),
+                          MakeUintegerChecker<uint32_t>(20))
+            .AddAttribute("BurstSize",
+                          "Packets sent back to back in a burst",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&UrllcSource::m_burstSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("Interval",
+                          "Mean time between two bursts",
+                          TimeValue(MilliSeconds(10)),
+                          MakeTimeAccessor(&UrllcSource::m_interval),
+                          MakeTimeChecker(NanoSeconds(1)))
+            .AddAttribute("Poisson",
+                          "Exponential time between bursts (Poisson arrivals) instead of a constant one",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&UrllcSource::m_poisson),
+                          MakeBooleanChecker())
+            .AddAttribute("Deadline",
+                          "Delivery budget of every packet, from its send time",
+                          TimeValue(MilliSeconds(1)),
+                          MakeTimeAccessor(&UrllcSource::m_deadline),
+                          MakeTimeChecker())
+            .AddTraceSource("Tx",
+                            "A packet is sent",
+                            MakeTraceSourceAccessor(&UrllcSource::m_txTrace),
+                            "ns3::Packet::TracedCallback");
+    return tid;
+}
+
+UrllcSource::UrllcSource()
+    : m_arrivals(CreateObject<ExponentialRandomVariable>())
+{
+}
+
+UrllcSource::~UrllcSource()
+{
+}
+
+int64_t
+UrllcSource::AssignStreams(int64_t stream)
+{
+    m_arrivals->SetStream(stream);
+    return 1;
+}
+
+uint64_t
+UrllcSource::GetSent() const
+{
+    return m_sent;
+}
+
+void
+UrllcSource::DoDispose()
+{
+    m_socket = nullptr;
+    Application::DoDispose();
+}
+
+void
+UrllcSource::StartApplication()
+{
+    if (!m_socket)
+    {
+        m_socket = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
+        m_socket->Bind();
+        if (Ipv4Address::IsMatchingType(m_peerAddress))
+        {
+            m_socket->Connect(InetSocketAddress(Ipv4Address::ConvertFrom(m_peerAddress), m_peerPort));
+        }
+        else
+        {
+            NS_ABORT_MSG_IF(!InetSocketAddress::IsMatchingType(m_peerAddress),
+                            "UrllcSource needs an IPv4 remote address");
+            m_socket->Connect(m_peerAddress);
+        }
+    }
+    ScheduleBurst();
+}
+
+void
+UrllcSource::StopApplication()
+{
+    Simulator::Cancel(m_sendEvent);
+}
+
+void
+UrllcSource::ScheduleBurst()
+{
+    Time wait = m_poisson ? Seconds(m_arrivals->GetValue(m_interval.GetSeconds(), 0)) : m_interval;
+    m_sendEvent = Simulator::Schedule(wait, &UrllcSource::SendBurst, this);
+}
+
+void
+UrllcSource::SendBurst()
+{
+    for (uint32_t i = 0; i < m_burstSize; ++i)
+    {
+        SeqTsHeader seqTs;
+        seqTs.SetSeq(m_sent++);
+        DeadlineHeader deadline;
+        deadline.SetDeadline(Simulator::Now() + m_deadline);
+
+        Ptr<Packet> packet = Create<Packet>(m_packetSize - seqTs.GetSerializedSize() - deadline.GetSerializedSize());
+        packet->AddHeader(deadline);
+        packet->AddHeader(seqTs);
+        m_txTrace(packet);
+        m_socket->Send(packet);
+    }
+    ScheduleBurst();
+}
+
+TypeId
+UrllcSink::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::UrllcSink")
+                            .SetParent<Application>()
+                            .SetGroupName("Applications")
+                            .AddConstructor<UrllcSink>()
+                            .AddAttribute("Port",
+                                          "Port on which the packets are received",
+                                          UintegerValue(100),
+                                          MakeUintegerAccessor(&UrllcSink::m_port),
+                                          MakeUintegerChecker<uint16_t>())
+                            .AddTraceSource("Rx",
+                                            "A packet is received",
+                                            MakeTraceSourceAccessor(&UrllcSink::m_rxTrace),
+                                            "ns3::Packet::TracedCallback");
+    return tid;
+}
+
+UrllcSink::UrllcSink()
+{
+}
+
+UrllcSink::~UrllcSink()
+{
+}
+
+uint64_t
+UrllcSink::GetReceived() const
+{
+    return m_received;
+}
+
+uint64_t
+UrllcSink::GetOnTime() const
+{
+    return m_onTime;
+}
+
+uint64_t
+UrllcSink::GetLate() const
+{
+    return m_late;
+}
+
+uint64_t
+UrllcSink::GetLost() const
+{
+    return m_expected - m_received;
+}
+
+Time
+UrllcSink::GetBudget() const
+{
+    return m_budget;
+}
+
+const LatencySketch&
+UrllcSink::GetDelay() const
+{
+    return m_delay;
+}
+
+void
+UrllcSink::DoDispose()
+{
+    m_socket = nullptr;
+    Application::DoDispose();
+}
+
+void
+UrllcSink::StartApplication()
+{
+    if (!m_socket)
+    {
+        m_socket = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
+        NS_ABORT_MSG_IF(m_socket->Bind(InetSocketAddress(Ipv4Address::GetAny(), m_port)) == -1,
+                        "Failed to bind the URLLC sink socket");
+    }
+    m_socket->SetRecvCallback(MakeCallback(&UrllcSink::HandleRead, this));
+}
+
+void
+UrllcSink::StopApplication()
+{
+    if (m_socket)
+    {
+        m_socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
+    }
+}
+
+void
+UrllcSink::HandleRead(Ptr<Socket> socket)
+{
+    Ptr<Packet> packet;
+    Address from;
+    while ((packet = socket->RecvFrom(from)))
+    {
+        SeqTsHeader seqTs;
+        DeadlineHeader deadline;
+        if (packet->GetSize() < seqTs.GetSerializedSize() + deadline.GetSerializedSize())
+        {
+            continue;
+        }
+        m_rxTrace(packet);
+        packet->RemoveHeader(seqTs);
+        packet->RemoveHeader(deadline);
+
+        Time now = Simulator::Now();
+        ++m_received;
+        if (now <= deadline.GetDeadline())
+        {
+            ++m_onTime;
+        }
+        else
+        {
+            ++m_late;
+        }
+        m_delay.Add(now - seqTs.GetTs());
+        m_budget = deadline.GetDeadline() - seqTs.GetTs();
+        m_expected = std::max<uint64_t>(m_expected, seqTs.GetSeq() + 1);
+    }
+}
+
+UrllcHelper::UrllcHelper()
+{
+    m_sourceFactory.SetTypeId(UrllcSource::GetTypeId());
+}
+
+void
+UrllcHelper::SetSourceAttribute(std::string name, const AttributeValue& value)
+{
+    m_sourceFactory.Set(name, value);
+}
+
+ApplicationContainer
+UrllcHelper::InstallSource(Ptr<Node> node, Address remote, uint16_t port) const
+{
+    Ptr<UrllcSource> source = m_sourceFactory.Create<UrllcSource>();
+    source->SetAttribute("RemoteAddress", AddressValue(remote));
+    source->SetAttribute("RemotePort", UintegerValue(port));
+    node->AddApplication(source);
+    return ApplicationContainer(source);
+}
+
+ApplicationContainer
+UrllcHelper::InstallSink(NodeContainer nodes, uint16_t port) const
+{
+    ApplicationContainer apps;
+    for (auto it = nodes.Begin(); it != nodes.End(); ++it)
+    {
+        Ptr<UrllcSink> sink = CreateObject<UrllcSink>();
+        sink->SetAttribute("Port", UintegerValue(port));
+        (*it)->AddApplication(sink);
+        apps.Add(sink);
+    }
+    return apps;
+}
+
+int64_t
+UrllcHelper::AssignStreams(ApplicationContainer apps, int64_t stream)
+{
+    int64_t currentStream = stream;
+    for (auto it = apps.Begin(); it != apps.End(); ++it)
+    {
+        Ptr<UrllcSource> source = DynamicCast<UrllcSource>(*it);
+        if (source)
+        {
+            currentStream += source->AssignStreams(currentStream);
+        }
+    }
+    return currentStream - stream;
+}
+
+double
+UrllcHelper::GetReliability(const ApplicationContainer& sinks)
+{
+    uint64_t onTime = 0;
+    uint64_t expected = 0;
+    for (auto it = sinks.Begin(); it != sinks.End(); ++it)
+    {
+        if (Ptr<UrllcSink> sink = DynamicCast<UrllcSink>(*it))
+        {
+            onTime += sink->GetOnTime();
+            expected += sink->GetOnTime() + sink->GetLate() + sink->GetLost();
+        }
+    }
+    return expected > 0 ? 100.0 * onTime / expected : std::nan("");
+}
+
+void
+UrllcHelper::PrintSummary(std::ostream& os, const ApplicationContainer& sinks)
+{
+    uint64_t onTime = 0;
+    uint64_t late = 0;
+    uint64_t lost = 0;
+    Time budget;
+    LatencySketch delay;
+    for (auto it = sinks.Begin(); it != sinks.End(); ++it)
+    {
+        Ptr<UrllcSink> sink = DynamicCast<UrllcSink>(*it);
+        if (!sink)
+        {
+            continue;
+        }
+        os << "  UE node " << sink->GetNode()->GetId() << ": " << sink->GetOnTime() << " on time, "
+           << sink->GetLate() << " late, " << sink->GetLost() << " lost\n";
+        onTime += sink->GetOnTime();
+        late += sink->GetLate();
+        lost += sink->GetLost();
+        budget = std::max(budget, sink->GetBudget());
+        delay.Merge(sink->GetDelay());
+    }
+
+    uint64_t expected = onTime + late + lost;
+    os << "  Deadline budget: " << budget.GetSeconds() * 1000 << " ms\n";
+    os << "  Deadline on time/late/lost: " << onTime << " / " << late << " / " << lost << "\n";
+    os << "  Deadline reliability: " << (expected > 0 ? 100.0 * onTime / expected : 0.0) << " %\n";
+
+    // Lost packets are never delivered, so the delay reached by a fraction r
+    // of the packets is the quantile r * expected / received of the received ones
+    os << "  Delay at 99.9/99.99/99.999% reliability: ";
+    const double reliabilities[] = {0.999, 0.9999, 0.99999};
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        os << (i > 0 ? " / " : "");
+        double rank = reliabilities[i] * expected;
+        if (expected == 0 || rank > delay.GetCount())
+        {
+            os << "n/a";
+        }
+        else
+        {
+            os << delay.GetQuantile(rank / delay.GetCount()).GetSeconds() * 1000;
+        }
+    }
+    os << " ms\n";
+}
+
+} // namespace ns3
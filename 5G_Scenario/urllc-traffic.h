@@ -0,0 +1,162 @@
+#ifndef URLLC_TRAFFIC_H
+#define URLLC_TRAFFIC_H
+
+#include "latency-stats.h"
+
+#include "ns3/address.h"
+#include "ns3/application-container.h"
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/header.h"
+#include "ns3/node-container.h"
+#include "ns3/object-factory.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/socket.h"
+#include "ns3/traced-callback.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace ns3
+{
+
+/// Absolute delivery deadline of a packet, after its SeqTsHeader
+class DeadlineHeader : public Header
+{
+  public:
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+
+    void SetDeadline(Time deadline);
+    Time GetDeadline() const;
+
+    uint32_t GetSerializedSize() const override;
+    void Serialize(Buffer::Iterator start) const override;
+    uint32_t Deserialize(Buffer::Iterator start) override;
+    void Print(std::ostream& os) const override;
+
+  private:
+    uint64_t m_deadline{0};
+};
+
+/**
+ * Downlink URLLC source: bursts of BurstSize packets, with exponential
+ * (Poisson arrivals) or constant spacing of mean Interval. Every packet
+ * carries a SeqTsHeader and a DeadlineHeader set to its send time plus
+ * Deadline, padded to PacketSize bytes.
+ */
+class UrllcSource : public Application
+{
+  public:
+    static TypeId GetTypeId();
+
+    UrllcSource();
+    ~UrllcSource() override;
+
+    /// Assign a fixed random variable stream, returns the number used
+    int64_t AssignStreams(int64_t stream);
+
+    uint64_t GetSent() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    void StartApplication() override;
+    void StopApplication() override;
+
+    void SendBurst();
+    void ScheduleBurst();
+
+    Address m_peerAddress;
+    uint16_t m_peerPort;
+    uint32_t m_packetSize;
+    uint32_t m_burstSize;
+    Time m_interval;
+    bool m_poisson;
+    Time m_deadline;
+
+    Ptr<ExponentialRandomVariable> m_arrivals;
+    Ptr<Socket> m_socket;
+    EventId m_sendEvent;
+    uint32_t m_sent{0};
+
+    TracedCallback<Ptr<const Packet>> m_txTrace;
+};
+
+/**
+ * Sink of the URLLC packets of one UE. A packet received by its deadline is
+ * on time, one received after it is late; packets whose sequence number was
+ * skipped and never arrived are lost.
+ */
+class UrllcSink : public Application
+{
+  public:
+    static TypeId GetTypeId();
+
+    UrllcSink();
+    ~UrllcSink() override;
+
+    uint64_t GetReceived() const;
+    uint64_t GetOnTime() const;
+    uint64_t GetLate() const;
+    /// Packets up to the highest sequence number received that never arrived
+    uint64_t GetLost() const;
+    /// Deadline budget of the last packet received
+    Time GetBudget() const;
+    const LatencySketch& GetDelay() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    void StartApplication() override;
+    void StopApplication() override;
+
+    void HandleRead(Ptr<Socket> socket);
+
+    uint16_t m_port;
+    Ptr<Socket> m_socket;
+    uint64_t m_received{0};
+    uint64_t m_onTime{0};
+    uint64_t m_late{0};
+    uint64_t m_expected{0};
+    Time m_budget;
+    LatencySketch m_delay;
+
+    TracedCallback<Ptr<const Packet>> m_rxTrace;
+};
+
+/// Installs UrllcSource and UrllcSink applications
+class UrllcHelper
+{
+  public:
+    UrllcHelper();
+
+    void SetSourceAttribute(std::string name, const AttributeValue& value);
+
+    ApplicationContainer InstallSource(Ptr<Node> node, Address remote, uint16_t port) const;
+    ApplicationContainer InstallSink(NodeContainer nodes, uint16_t port) const;
+
+    /// Assign fixed random variable streams to the UrllcSource applications, returns the number used
+    static int64_t AssignStreams(ApplicationContainer apps, int64_t stream);
+
+    /**
+     * Print the on time, late and lost packets of every sink and the
+     * reliability over all of them: the fraction of packets delivered by
+     * their deadline, and the delay reached by 99.9%, 99.99% and 99.999% of
+     * the packets (lost ones count as never delivered).
+     */
+    static void PrintSummary(std::ostream& os, const ApplicationContainer& sinks);
+
+    /// Packets delivered by their deadline over all the sinks, in % (NaN without packets)
+    static double GetReliability(const ApplicationContainer& sinks);
+
+  private:
+    ObjectFactory m_sourceFactory;
+};
+
+} // namespace ns3
+
+#endif // URLLC_TRAFFIC_H
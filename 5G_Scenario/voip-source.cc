@@ -0,0 +1,246 @@
+#include "voip-source.h"
+
+#include "ns3/abort.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/seq-ts-header.h"
+#include "ns3/simulator.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <utility>
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(VoipSource);
+
+TypeId
+VoipSource::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::VoipSource")
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .AddConstructor<VoipSource>()
+            .AddAttribute("RemoteAddress",
+                          "Destination address of the voice packets",
+                          AddressValue(),
+                          MakeAddressAccessor(&VoipSource::m_peerAddress),
+                          MakeAddressChecker())
+            .AddAttribute("RemotePort",
+                          "Destination port of the voice packets",
+                          UintegerValue(100),
+                          MakeUintegerAccessor(&VoipSource::m_peerPort),
+                          MakeUintegerChecker<uint16_t>())
+            .AddAttribute("FrameBytes",
+                          "Codec payload of a speech frame in bytes, without the RTP header",
+                          UintegerValue(33),
+                          MakeUintegerAccessor(&VoipSource::m_frameBytes),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("SidBytes",
+                          "Codec payload of a SID frame in bytes, without the RTP header",
+                          UintegerValue(7),
+                          MakeUintegerAccessor(&VoipSource::m_sidBytes),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("FramePeriod",
+                          "Duration of a codec frame",
+                          TimeValue(MilliSeconds(20)),
+                          MakeTimeAccessor(&VoipSource::m_framePeriod),
+                          MakeTimeChecker(MilliSeconds(1)))
+            .AddAttribute("SidPeriod",
+                          "Frames between two SID frames during a silence",
+                          UintegerValue(8),
+                          MakeUintegerAccessor(&VoipSource::m_sidPeriod),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MeanTalkspurt",
+                          "Mean duration of a talkspurt",
+                          TimeValue(MilliSeconds(1004)),
+                          MakeTimeAccessor(&VoipSource::m_meanTalkspurt),
+                          MakeTimeChecker())
+            .AddAttribute("MeanSilence",
+                          "Mean duration of a silence",
+                          TimeValue(MilliSeconds(1587)),
+                          MakeTimeAccessor(&VoipSource::m_meanSilence),
+                          MakeTimeChecker())
+            .AddTraceSource("Tx",
+                            "A voice packet is sent",
+                            MakeTraceSourceAccessor(&VoipSource::m_txTrace),
+                            "ns3::Packet::TracedCallback");
+    return tid;
+}
+
+VoipSource::VoipSource()
+    : m_duration(CreateObject<ExponentialRandomVariable>()),
+      m_start(CreateObject<UniformRandomVariable>())
+{
+}
+
+VoipSource::~VoipSource()
+{
+}
+
+int64_t
+VoipSource::AssignStreams(int64_t stream)
+{
+    m_duration->SetStream(stream);
+    m_start->SetStream(stream + 1);
+    return 2;
+}
+
+uint64_t
+VoipSource::GetSpeechFrames() const
+{
+    return m_speechFrames;
+}
+
+uint64_t
+VoipSource::GetSidFrames() const
+{
+    return m_sidFrames;
+}
+
+void
+VoipSource::DoDispose()
+{
+    m_socket = nullptr;
+    Application::DoDispose();
+}
+
+void
+VoipSource::StartApplication()
+{
+    if (!m_socket)
+    {
+        m_socket = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
+        m_socket->Bind();
+        if (Ipv4Address::IsMatchingType(m_peerAddress))
+        {
+            m_socket->Connect(InetSocketAddress(Ipv4Address::ConvertFrom(m_peerAddress), m_peerPort));
+        }
+        else
+        {
+            NS_ABORT_MSG_IF(!InetSocketAddress::IsMatchingType(m_peerAddress),
+                            "VoipSource needs an IPv4 remote address");
+            m_socket->Connect(m_peerAddress);
+        }
+    }
+
+    double activity = m_meanTalkspurt.GetSeconds() / (m_meanTalkspurt + m_meanSilence).GetSeconds();
+    m_talking = m_start->GetValue() < activity;
+    m_framesLeft = DrawFrames(m_talking ? m_meanTalkspurt : m_meanSilence);
+    m_sendEvent = Simulator::Schedule(Seconds(m_framePeriod.GetSeconds() * m_start->GetValue()),
+                                      &VoipSource::SendFrame,
+                                      this);
+}
+
+void
+VoipSource::StopApplication()
+{
+    Simulator::Cancel(m_sendEvent);
+}
+
+uint32_t
+VoipSource::DrawFrames(Time mean) const
+{
+    double frames = std::ceil(m_duration->GetValue(mean.GetSeconds(), 0) / m_framePeriod.GetSeconds());
+    return std::max(1u, static_cast<uint32_t>(frames));
+}
+
+void
+VoipSource::Send(uint32_t payloadBytes)
+{
+    Ptr<Packet> packet = Create<Packet>(payloadBytes);
+    SeqTsHeader seqTs;
+    seqTs.SetSeq(m_sent++);
+    packet->AddHeader(seqTs);
+    m_txTrace(packet);
+    m_socket->Send(packet);
+}
+
+void
+VoipSource::SendFrame()
+{
+    // One speech frame per frame period in a talkspurt, a SID at the start
+    // of a silence and then every SidPeriod frames
+    uint32_t frames;
+    if (m_talking)
+    {
+        Send(m_frameBytes);
+        ++m_speechFrames;
+        frames = 1;
+    }
+    else
+    {
+        Send(m_sidBytes);
+        ++m_sidFrames;
+        frames = std::min(m_sidPeriod, m_framesLeft);
+    }
+
+    m_framesLeft -= frames;
+    if (m_framesLeft == 0)
+    {
+        m_talking = !m_talking;
+        m_framesLeft = DrawFrames(m_talking ? m_meanTalkspurt : m_meanSilence);
+    }
+    m_sendEvent = Simulator::Schedule(m_framePeriod * frames, &VoipSource::SendFrame, this);
+}
+
+VoipSourceHelper::VoipSourceHelper()
+{
+    m_factory.SetTypeId(VoipSource::GetTypeId());
+}
+
+void
+VoipSourceHelper::SetAttribute(std::string name, const AttributeValue& value)
+{
+    m_factory.Set(name, value);
+}
+
+void
+VoipSourceHelper::SetCodec(const std::string& codec)
+{
+    // Speech and SID payloads in bytes, including the codec payload header
+    static const std::map<std::string, std::pair<uint32_t, uint32_t>> frameBytes = {
+        {"amr-nb", {32, 7}},
+        {"amr-wb", {33, 7}},
+        {"evs", {33, 6}},
+    };
+    auto it = frameBytes.find(codec);
+    NS_ABORT_MSG_IF(it == frameBytes.end(), "Unknown voice codec " << codec << " (expected amr-nb, amr-wb or evs)");
+    m_factory.Set("FrameBytes", UintegerValue(it->second.first));
+    m_factory.Set("SidBytes", UintegerValue(it->second.second));
+}
+
+ApplicationContainer
+VoipSourceHelper::Install(NodeContainer nodes) const
+{
+    ApplicationContainer apps;
+    for (auto it = nodes.Begin(); it != nodes.End(); ++it)
+    {
+        Ptr<VoipSource> source = m_factory.Create<VoipSource>();
+        (*it)->AddApplication(source);
+        apps.Add(source);
+    }
+    return apps;
+}
+
+int64_t
+VoipSourceHelper::AssignStreams(ApplicationContainer apps, int64_t stream)
+{
+    int64_t currentStream = stream;
+    for (auto it = apps.Begin(); it != apps.End(); ++it)
+    {
+        Ptr<VoipSource> source = DynamicCast<VoipSource>(*it);
+        if (source)
+        {
+            currentStream += source->AssignStreams(currentStream);
+        }
+    }
+    return currentStream - stream;
+}
+
+} // namespace ns3
@@ -0,0 +1,118 @@
+#ifndef VOIP_SOURCE_H
+#define VOIP_SOURCE_H
+
+#include "ns3/address.h"
+#include "ns3/application-container.h"
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/node-container.h"
+#include "ns3/object-factory.h"
+#include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/socket.h"
+#include "ns3/traced-callback.h"
+
+#include <cstdint>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * Voice source with an AMR/EVS-like frame model.
+ *
+ * The source alternates between talkspurts and silences of exponentially
+ * distributed length (ITU-T P.59 means of 1.004 s and 1.587 s by default),
+ * both rounded to whole codec frames. During a talkspurt it sends one
+ * speech frame every FramePeriod; a silence starts with a SID frame and
+ * sends one every SidPeriod frames, as the DTX of the codecs does. The start
+ * is shifted by a random fraction of a frame and begins in a talkspurt with
+ * the voice activity probability, so that many sources do not send in step.
+ *
+ * Every packet carries a 12 byte SeqTsHeader, the size of the RTP header it
+ * stands for, in front of the codec frame, so UdpServer counts the losses
+ * and the delay probe reads the send time as with UdpClient; UDP and IP add
+ * their own headers below. Every frame is a new packet with a zero-filled
+ * payload, which ns-3 does not back with memory, and the header is written
+ * in the headroom of its buffer, so a frame costs what a UdpClient packet
+ * does. (Copying a shared template instead would copy its buffer on every
+ * AddHeader, the buffer being shared.)
+ */
+class VoipSource : public Application
+{
+  public:
+    static TypeId GetTypeId();
+
+    VoipSource();
+    ~VoipSource() override;
+
+    /// Assign fixed random variable streams, returns the number used
+    int64_t AssignStreams(int64_t stream);
+
+    uint64_t GetSpeechFrames() const;
+    uint64_t GetSidFrames() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    void StartApplication() override;
+    void StopApplication() override;
+
+    /// Send the frame of this instant and schedule the next one
+    void SendFrame();
+    /// Number of frames, at least one, of an exponential duration
+    uint32_t DrawFrames(Time mean) const;
+    void Send(uint32_t payloadBytes);
+
+    Address m_peerAddress;
+    uint16_t m_peerPort;
+    uint32_t m_frameBytes;
+    uint32_t m_sidBytes;
+    Time m_framePeriod;
+    uint32_t m_sidPeriod;
+    Time m_meanTalkspurt;
+    Time m_meanSilence;
+
+    Ptr<ExponentialRandomVariable> m_duration;
+    Ptr<UniformRandomVariable> m_start;
+
+    Ptr<Socket> m_socket;
+    EventId m_sendEvent;
+
+    bool m_talking{false};
+    /// Frames left in the current talkspurt or silence
+    uint32_t m_framesLeft{0};
+    uint32_t m_sent{0};
+    uint64_t m_speechFrames{0};
+    uint64_t m_sidFrames{0};
+
+    TracedCallback<Ptr<const Packet>> m_txTrace;
+};
+
+/// Installs VoipSource applications, as UdpClientHelper does for UdpClient
+class VoipSourceHelper
+{
+  public:
+    VoipSourceHelper();
+
+    void SetAttribute(std::string name, const AttributeValue& value);
+
+    /**
+     * Frame sizes of a codec at its common VoIP mode: amr-nb (12.2 kbps),
+     * amr-wb (12.65 kbps) or evs (13.2 kbps)
+     */
+    void SetCodec(const std::string& codec);
+
+    ApplicationContainer Install(NodeContainer nodes) const;
+
+    /// Assign fixed random variable streams to the VoipSource applications, returns the number used
+    static int64_t AssignStreams(ApplicationContainer apps, int64_t stream);
+
+  private:
+    ObjectFactory m_factory;
+};
+
+} // namespace ns3
+
+#endif // VOIP_SOURCE_H